@@ -0,0 +1,368 @@
+// -----------------------------
+// projects/graph/BenchGraph.c++
+// Copyright (C) 2014
+// Glenn P. Downing
+// -----------------------------
+
+// https://github.com/google/benchmark/blob/main/docs/user_guide.md
+
+/*
+Google Benchmark Libraries:
+    % ls -al /usr/include/benchmark/
+    ...
+    benchmark.h
+    ...
+
+    % locate libbenchmark.so
+    /usr/lib/x86_64-linux-gnu/libbenchmark.so
+
+To compile the benchmark:
+    % g++ -O2 -DNDEBUG -pedantic -std=c++11 -Wall BenchGraph.c++ -o BenchGraph -lbenchmark -lpthread
+
+To run the benchmark and keep the results as JSON:
+    % BenchGraph --benchmark_format=json --benchmark_out=BenchGraph.json
+
+To run one graph type, generator or size (names are operation/graph/generator/vertices):
+    % BenchGraph --benchmark_filter='/Graph/rmat/'
+
+To include the 10^7 vertex graphs (several GB for boost::adjacency_list):
+    % BenchGraph --max_vertices=10000000
+
+peak_rss_mb is the high-water mark of the resident set while the graph of a
+configuration was built, which includes its edge list; freed heap is trimmed and the
+mark is reset through /proc/self/clear_refs before each build (Linux 4.0 or later).
+graph_heap_mb is the growth of the malloc heap while the graph was built (glibc 2.33 or later).
+*/
+
+// --------
+// includes
+// --------
+
+#include <cmath>     // sqrt
+#include <cstddef>   // size_t
+#include <cstdint>   // int64_t, uint64_t
+#include <cstdio>    // fclose, fgets, fopen, fputs, sscanf
+#include <cstdlib>   // strtoul
+#include <cstring>   // strncmp
+#include <memory>    // unique_ptr
+#include <random>    // mt19937_64, uniform_int_distribution, uniform_real_distribution
+#include <string>    // string
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include <malloc.h> // mallinfo2, malloc_trim
+
+#include "boost/graph/adjacency_list.hpp" // adjacency_list
+
+#include "benchmark/benchmark.h"
+
+#include "Graph.h"
+
+typedef std::vector<std::pair<int, int> > edge_list;
+
+// ----------
+// generators
+// ----------
+
+// Every generator is seeded from its arguments, so a revision is always measured on the same graphs.
+
+/**
+ * @param n - number of vertices
+ * @return 8n directed edges with uniformly random endpoints
+ */
+edge_list erdos_renyi (int n) {
+    std::mt19937_64                    r(n);
+    std::uniform_int_distribution<int> d(0, n - 1);
+    const std::size_t                  m = 8 * static_cast<std::size_t>(n);
+    edge_list                          x;
+    x.reserve(m);
+    for (std::size_t i = 0; i != m; ++i) {
+        const int u = d(r);
+        x.push_back(std::make_pair(u, d(r)));}
+    return x;}
+
+/**
+ * @param n - number of vertices
+ * @return 8n directed edges from the recursive matrix model with the Graph 500
+ *         probabilities (0.57, 0.19, 0.19, 0.05), which gives power-law degrees
+ */
+edge_list rmat (int n) {
+    int scale = 0;
+    while ((1 << scale) < n)
+        ++scale;
+    std::mt19937_64                        r(n);
+    std::uniform_real_distribution<double> d(0, 1);
+    const std::size_t                      m = 8 * static_cast<std::size_t>(n);
+    edge_list                              x;
+    x.reserve(m);
+    while (x.size() != m) {
+        int u = 0;
+        int v = 0;
+        for (int b = 0; b != scale; ++b) {
+            const double p = d(r);
+            u = 2 * u + (p >= 0.76);
+            v = 2 * v + (((p >= 0.57) && (p < 0.76)) || (p >= 0.95));}
+        if ((u < n) && (v < n))
+            x.push_back(std::make_pair(u, v));}
+    return x;}
+
+/**
+ * @param n - number of vertices, rounded down to a square
+ * @return edges from every cell of a square grid to its right and lower neighbors
+ */
+edge_list grid (int n) {
+    const int s = static_cast<int>(std::sqrt(static_cast<double>(n)));
+    edge_list x;
+    x.reserve(2 * static_cast<std::size_t>(s) * s);
+    for (int i = 0; i != s; ++i)
+        for (int j = 0; j != s; ++j) {
+            if (j + 1 != s)
+                x.push_back(std::make_pair(i * s + j, i * s + j + 1));
+            if (i + 1 != s)
+                x.push_back(std::make_pair(i * s + j, (i + 1) * s + j));}
+    return x;}
+
+struct generator {
+    const char* name;
+    edge_list (*make) (int);};
+
+const generator generators[] = {
+    {"erdos_renyi", &erdos_renyi},
+    {"rmat",        &rmat},
+    {"grid",        &grid}};
+
+// ------
+// memory
+// ------
+
+/**
+ * @return bytes of the heap in use by this process, including blocks malloc mapped directly
+ */
+double heap_bytes () {
+    const struct mallinfo2 m = mallinfo2();
+    return static_cast<double>(m.uordblks + m.hblkhd);}
+
+/**
+ * returns freed heap to the system, then lowers the resident set high-water mark
+ * of this process to its current resident set
+ */
+void reset_peak_resident () {
+    malloc_trim(0);
+    std::FILE* f = std::fopen("/proc/self/clear_refs", "w");
+    if (f) {
+        std::fputs("5", f);
+        std::fclose(f);}}
+
+/**
+ * @return high-water mark of the resident set size of this process in bytes, VmHWM in /proc/self/status
+ */
+double peak_resident_bytes () {
+    unsigned long kb   = 0;
+    char          line[256];
+    std::FILE*    f    = std::fopen("/proc/self/status", "r");
+    if (f) {
+        while (std::fgets(line, sizeof(line), f))
+            if (std::sscanf(line, "VmHWM: %lu kB", &kb) == 1)
+                break;
+        std::fclose(f);}
+    return static_cast<double>(kb) * 1024;}
+
+// -------
+// fixture
+// -------
+
+// frees the edge list and graph of the fixture built last, whatever its graph type
+void (*release_fixture) () = 0;
+
+/**
+ * one edge list and one graph built from it, shared by the benchmarks of a configuration
+ * the benchmarks are registered configuration by configuration, so each graph is built once
+ * and only one graph is alive at a time
+ */
+template <typename G>
+struct fixture {
+    std::string        key;
+    edge_list          x;
+    std::unique_ptr<G> g;
+    double             graph_bytes;
+    double             peak_bytes;
+
+    static fixture& instance () {
+        static fixture f;
+        return f;}
+
+    static void release () {
+        fixture& f = instance();
+        f.key.clear();
+        f.g.reset();
+        edge_list().swap(f.x);}
+
+    static fixture& get (const generator& gen, int n) {
+        fixture&          f   = instance();
+        const std::string key = std::string(gen.name) + "/" + std::to_string(n);
+        if (f.key != key) {
+            if (release_fixture)
+                release_fixture();
+            release_fixture = &fixture::release;
+            reset_peak_resident();
+            f.x   = gen.make(n);
+            f.key = key;
+            const double before = heap_bytes();
+            f.g.reset(new G);
+            for (std::size_t i = 0; i != f.x.size(); ++i)
+                add_edge(f.x[i].first, f.x[i].second, *f.g);
+            f.graph_bytes = heap_bytes() - before;
+            f.peak_bytes  = peak_resident_bytes();}
+        return f;}};
+
+/**
+ * @param state - benchmark state
+ * @param f     - fixture whose graph the benchmark measured
+ * reports the edge count and both memory figures
+ */
+template <typename G>
+void report (benchmark::State& state, const fixture<G>& f) {
+    state.counters["vertices"]      = static_cast<double>(num_vertices(*f.g));
+    state.counters["edges"]         = static_cast<double>(num_edges(*f.g));
+    state.counters["graph_heap_mb"] = f.graph_bytes / (1 << 20);
+    state.counters["peak_rss_mb"]   = f.peak_bytes / (1 << 20);}
+
+// ----------
+// benchmarks
+// ----------
+
+/**
+ * builds the graph with one add_edge per listed edge; items are edges offered
+ */
+template <typename G>
+void bench_add_edge (benchmark::State& state, const generator* gen, int n) {
+    fixture<G>& f = fixture<G>::get(*gen, n);
+    for (auto _ : state) {
+        std::unique_ptr<G> g(new G);
+        for (std::size_t i = 0; i != f.x.size(); ++i)
+            add_edge(f.x[i].first, f.x[i].second, *g);
+        benchmark::DoNotOptimize(g.get());
+        state.PauseTiming();
+        g.reset();
+        state.ResumeTiming();}
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(f.x.size()));
+    report(state, f);}
+
+/**
+ * one edge() call per iteration, so the time per iteration is the lookup latency;
+ * half of the queries are edges of the graph and half are random pairs
+ */
+template <typename G>
+void bench_edge (benchmark::State& state, const generator* gen, int n) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    fixture<G>& f = fixture<G>::get(*gen, n);
+    const G&    g = *f.g;
+
+    const int                          v = static_cast<int>(num_vertices(g));
+    std::mt19937_64                    r(1);
+    std::uniform_int_distribution<int> any(0, v - 1);
+    std::uniform_int_distribution<std::size_t> listed(0, f.x.size() - 1);
+    std::vector<std::pair<vertex_descriptor, vertex_descriptor> > q;
+    for (int i = 0; i != (1 << 16); ++i)
+        if (i % 2 == 0) {
+            const std::pair<int, int>& e = f.x[listed(r)];
+            q.push_back(std::make_pair(e.first, e.second));}
+        else {
+            const int a = any(r);
+            q.push_back(std::make_pair(a, any(r)));}
+
+    std::size_t i     = 0;
+    std::size_t found = 0;
+    for (auto _ : state) {
+        found += edge(q[i].first, q[i].second, g).second;
+        i = (i + 1) & (q.size() - 1);}
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations());
+    report(state, f);}
+
+/**
+ * one iteration visits every vertex and every target in its adjacency range; items are edges visited
+ */
+template <typename G>
+void bench_adjacent_vertices (benchmark::State& state, const generator* gen, int n) {
+    typedef typename G::vertex_iterator    vertex_iterator;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+    fixture<G>& f = fixture<G>::get(*gen, n);
+    const G&    g = *f.g;
+
+    for (auto _ : state) {
+        std::uint64_t s = 0;
+        std::pair<vertex_iterator, vertex_iterator> p = vertices(g);
+        for (; p.first != p.second; ++p.first) {
+            std::pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(*p.first, g);
+            for (; q.first != q.second; ++q.first)
+                s += *q.first;}
+        benchmark::DoNotOptimize(s);}
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(num_edges(g)));
+    report(state, f);}
+
+/**
+ * one iteration walks edges() and takes the source and target of each; items are edges visited
+ */
+template <typename G>
+void bench_edges (benchmark::State& state, const generator* gen, int n) {
+    typedef typename G::edge_iterator edge_iterator;
+    fixture<G>& f = fixture<G>::get(*gen, n);
+    const G&    g = *f.g;
+
+    for (auto _ : state) {
+        std::uint64_t s = 0;
+        std::pair<edge_iterator, edge_iterator> p = edges(g);
+        for (; p.first != p.second; ++p.first)
+            s += source(*p.first, g) ^ target(*p.first, g);
+        benchmark::DoNotOptimize(s);}
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(num_edges(g)));
+    report(state, f);}
+
+// --------
+// register
+// --------
+
+/**
+ * @param name         - graph name used in the benchmark names
+ * @param max_vertices - largest size to register
+ * registers the four operations for every generator and size, one configuration at a time
+ */
+template <typename G>
+void register_graph (const std::string& name, int max_vertices) {
+    for (std::size_t k = 0; k != sizeof(generators) / sizeof(generators[0]); ++k)
+        for (int n = 1000; n <= max_vertices; n *= 10) {
+            const generator*  gen    = &generators[k];
+            const std::string suffix = "/" + name + "/" + gen->name + "/" + std::to_string(n);
+            benchmark::RegisterBenchmark(("add_edge"          + suffix).c_str(), &bench_add_edge<G>,          gen, n)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("edge"              + suffix).c_str(), &bench_edge<G>,              gen, n);
+            benchmark::RegisterBenchmark(("adjacent_vertices" + suffix).c_str(), &bench_adjacent_vertices<G>, gen, n)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("edges"             + suffix).c_str(), &bench_edges<G>,             gen, n)->Unit(benchmark::kMillisecond);}}
+
+// ----
+// main
+// ----
+
+int main (int argc, char** argv) {
+    // --max_vertices=N is ours; everything else goes to Google Benchmark
+    int max_vertices = 1000000;
+    int k = 1;
+    for (int i = 1; i != argc; ++i)
+        if (std::strncmp(argv[i], "--max_vertices=", 15) == 0)
+            max_vertices = static_cast<int>(std::strtoul(argv[i] + 15, 0, 10));
+        else
+            argv[k++] = argv[i];
+    argc = k;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    // the same pairing as the typed tests in TestGraph.c++
+    register_graph<boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> >("boost", max_vertices);
+    register_graph<Graph>("Graph", max_vertices);
+    register_graph<CompactGraph>("CompactGraph", max_vertices);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;}
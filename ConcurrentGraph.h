@@ -0,0 +1,299 @@
+// --------------------------------
+// projects/graph/ConcurrentGraph.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef ConcurrentGraph_h
+#define ConcurrentGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max, sort
+#include <atomic>    // atomic, memory_order
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <mutex>     // lock_guard, mutex
+#include <stdexcept> // length_error
+#include <utility>   // make_pair, move, pair
+#include <vector>    // vector
+
+#include "Graph.h"
+
+// ---------------
+// ConcurrentGraph
+// ---------------
+
+/**
+ * write-only builder for a BasicGraph<OutEdgeS, LayoutS> that any number of threads may add to at once
+ * rows live in segments of doubling size that are never moved, so growing the graph
+ * never invalidates a row another thread is writing; each row is guarded by one of
+ * a fixed set of striped mutexes, and seal() hands the rows to an ordinary graph
+ */
+template <typename OutEdgeS = ordered_setS, typename LayoutS = indexedS>
+class ConcurrentGraph {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef BasicGraph<OutEdgeS, LayoutS> graph_type;
+
+        typedef typename graph_type::vertex_descriptor  vertex_descriptor;
+        typedef typename graph_type::edge_descriptor    edge_descriptor;
+        typedef typename graph_type::row_type           row_type;
+        typedef typename graph_type::vertices_size_type vertices_size_type;
+        typedef typename graph_type::edges_size_type    edges_size_type;
+
+    private:
+        // ---------
+        // constants
+        // ---------
+
+        static const unsigned    base_bits = 10;                  // segment 0 holds 2^base_bits rows
+        static const std::size_t segments  = 64 - base_bits + 1;  // enough for any size_t index
+        static const std::size_t stripes   = 1024;                // power of two
+
+        // ------
+        // stripe
+        // ------
+
+        /**
+         * a mutex and the number of edges added under it, alone on a cache line
+         */
+        struct alignas(64) stripe {
+            std::mutex      m;
+            edges_size_type edges;
+
+            stripe () :
+                    edges (0)
+                {}};
+
+        // ----
+        // data
+        // ----
+
+        std::atomic<row_type*>          _segments[segments]; // segment k > 0 holds rows [2^(base_bits+k-1), 2^(base_bits+k))
+        std::atomic<vertices_size_type> _num_vertices;
+        stripe                          _stripes[stripes];   // row u is guarded by _stripes[u % stripes]
+
+        // ------
+        // locate
+        // ------
+
+        /**
+         * @param i - row index
+         * @return segment holding row i and the position of row i in it
+         */
+        static std::pair<std::size_t, std::size_t> locate (std::size_t i) {
+            std::size_t q = i >> base_bits;
+            if (q == 0)
+                return std::make_pair(0, i);
+            std::size_t k = 0;
+            for (; q != 0; q >>= 1)
+                ++k;
+            return std::make_pair(k, i - (std::size_t(1) << (base_bits + k - 1)));}
+
+        /**
+         * @param k - segment index
+         * @return number of rows in segment k
+         */
+        static std::size_t capacity (std::size_t k) {
+            return std::size_t(1) << (k == 0 ? base_bits : base_bits + k - 1);}
+
+        // ---
+        // row
+        // ---
+
+        /**
+         * @param i - row index
+         * @return row i, allocating its segment if no thread has yet
+         * a thread that loses the race to publish a segment frees its own copy
+         */
+        row_type& row (std::size_t i) {
+            const std::pair<std::size_t, std::size_t> p = locate(i);
+            row_type* s = _segments[p.first].load(std::memory_order_acquire);
+            if (s == 0) {
+                row_type* t = new row_type[capacity(p.first)];
+                if (_segments[p.first].compare_exchange_strong(s, t, std::memory_order_acq_rel))
+                    s = t;
+                else
+                    delete [] t;}
+            return s[p.second];}
+
+        // ----
+        // grow
+        // ----
+
+        /**
+         * @param n - number of vertices the graph must have afterwards; never shrinks
+         * throws std::length_error if n exceeds graph_type::max_vertices()
+         */
+        void grow (vertices_size_type n) {
+            if (n > graph_type::max_vertices())
+                throw std::length_error("ConcurrentGraph: more vertices than vertex_descriptor can number");
+            vertices_size_type s = _num_vertices.load(std::memory_order_relaxed);
+            while ((s < n) && !_num_vertices.compare_exchange_weak(s, n, std::memory_order_relaxed))
+                {}}
+
+        // -----
+        // clear
+        // -----
+
+        void clear () {
+            for (std::size_t k = 0; k != segments; ++k)
+                delete [] _segments[k].exchange(0, std::memory_order_relaxed);
+            _num_vertices.store(0, std::memory_order_relaxed);
+            for (std::size_t i = 0; i != stripes; ++i)
+                _stripes[i].edges = 0;}
+
+    public:
+        // --------
+        // add_edge
+        // --------
+
+        /**
+         * @param u - vertex_descriptor
+         * @param v - vertex_descriptor
+         * @param g - reference to a ConcurrentGraph
+         * @return pair of edge_descriptor and boolean indicating whether the edge was new
+         * safe to call from any number of threads at once, together with add_edges and add_vertex
+         * throws std::length_error, adding nothing, if g would exceed graph_type::max_vertices()
+         */
+        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor u, vertex_descriptor v, ConcurrentGraph& g) {
+            assert(!(u < vertex_descriptor()) && !(v < vertex_descriptor()));
+            g.grow(static_cast<vertices_size_type>(std::max(u, v)) + 1);
+
+            edge_descriptor ed = std::make_pair(u, v);
+            row_type&       r  = g.row(u);
+            stripe&         s  = g._stripes[static_cast<std::size_t>(u) % stripes];
+            std::lock_guard<std::mutex> lock(s.m);
+            if (!r.insert(v))
+                return std::make_pair(ed, false);
+            ++s.edges;
+            return std::make_pair(ed, true);}
+
+        // ---------
+        // add_edges
+        // ---------
+
+        /**
+         * @param b - input iterator to the first edge_descriptor
+         * @param e - input iterator past the last edge_descriptor
+         * @param g - reference to a ConcurrentGraph
+         * @return edges_size_type - number of edges in [b, e) that were already in g or repeated in [b, e)
+         * the batch is sorted first, so each row's mutex is taken once per batch rather than once per edge
+         * safe to call from any number of threads at once, together with add_edge and add_vertex
+         * throws std::length_error, adding nothing, if g would exceed graph_type::max_vertices()
+         */
+        template <typename II>
+        friend edges_size_type add_edges (II b, II e, ConcurrentGraph& g) {
+            std::vector<edge_descriptor> batch(b, e);
+            if (batch.empty())
+                return 0;
+            std::sort(batch.begin(), batch.end());
+
+            vertices_size_type n = 0;
+            for (typename std::vector<edge_descriptor>::const_iterator i = batch.begin(); i != batch.end(); ++i) {
+                assert(!(i->first < vertex_descriptor()) && !(i->second < vertex_descriptor()));
+                n = std::max(n, static_cast<vertices_size_type>(std::max(i->first, i->second)) + 1);}
+            g.grow(n);
+
+            edges_size_type added = 0;
+            typename std::vector<edge_descriptor>::const_iterator i = batch.begin();
+            while (i != batch.end()) {
+                const vertex_descriptor u = i->first;
+                row_type&               r = g.row(u);
+                stripe&                 s = g._stripes[static_cast<std::size_t>(u) % stripes];
+                std::lock_guard<std::mutex> lock(s.m);
+                for (; (i != batch.end()) && (i->first == u); ++i)
+                    if (r.insert(i->second)) {
+                        ++s.edges;
+                        ++added;}}
+            return batch.size() - added;}
+
+        // ----------
+        // add_vertex
+        // ----------
+
+        /**
+         * @param g - reference to a ConcurrentGraph
+         * @return vertex_descriptor - a vertex no other call has returned
+         * throws std::length_error if g already holds graph_type::max_vertices()
+         */
+        friend vertex_descriptor add_vertex (ConcurrentGraph& g) {
+            vertices_size_type s = g._num_vertices.load(std::memory_order_relaxed);
+            do {
+                if (s >= graph_type::max_vertices())
+                    throw std::length_error("ConcurrentGraph: more vertices than vertex_descriptor can number");}
+            while (!g._num_vertices.compare_exchange_weak(s, s + 1, std::memory_order_relaxed));
+            return static_cast<vertex_descriptor>(s);}
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * @param g - reference to a ConcurrentGraph
+         * @return edges_size_type - number of edges added so far
+         * takes every stripe in turn, so it is exact only when no thread is adding
+         */
+        friend edges_size_type num_edges (ConcurrentGraph& g) {
+            edges_size_type m = 0;
+            for (std::size_t i = 0; i != stripes; ++i) {
+                std::lock_guard<std::mutex> lock(g._stripes[i].m);
+                m += g._stripes[i].edges;}
+            return m;}
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * @param g - constant reference to a ConcurrentGraph
+         * @return vertices_size_type - number of vertices added so far
+         */
+        friend vertices_size_type num_vertices (const ConcurrentGraph& g) {
+            return g._num_vertices.load(std::memory_order_relaxed);}
+
+        // ----
+        // seal
+        // ----
+
+        /**
+         * @param g - reference to a ConcurrentGraph that no thread is adding to
+         * @return graph_type - the graph built so far; g is left empty
+         * rows are moved, not copied; edges() of an indexedS result lists the edges in row order
+         */
+        friend graph_type seal (ConcurrentGraph& g) {
+            const vertices_size_type n = num_vertices(g);
+            std::vector<row_type>    rows;
+            rows.reserve(n);
+            for (vertices_size_type i = 0; i != n; ++i) {
+                const std::pair<std::size_t, std::size_t> p = locate(i);
+                row_type* s = g._segments[p.first].load(std::memory_order_acquire);
+                if (s == 0)
+                    rows.push_back(row_type());
+                else
+                    rows.push_back(std::move(s[p.second]));}
+            g.clear();
+            return graph_type(std::move(rows));}
+
+        // ------------
+        // constructors
+        // ------------
+
+        ConcurrentGraph () :
+                _num_vertices (0) {
+            for (std::size_t k = 0; k != segments; ++k)
+                _segments[k].store(0, std::memory_order_relaxed);}
+
+        ConcurrentGraph (const ConcurrentGraph&) = delete;
+        ConcurrentGraph& operator = (const ConcurrentGraph&) = delete;
+
+        ~ConcurrentGraph () {
+            clear();}};
+
+#endif // ConcurrentGraph_h
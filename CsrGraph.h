@@ -0,0 +1,477 @@
+// -------------------------
+// projects/graph/CsrGraph.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// -------------------------
+
+#ifndef CsrGraph_h
+#define CsrGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // is_sorted, lower_bound, sort
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <cstdint>   // int32_t, uint32_t, uint64_t, INT32_MAX
+#include <cstring>   // memcmp, memcpy
+#include <fstream>   // ofstream
+#include <memory>    // shared_ptr
+#include <stdexcept> // runtime_error
+#include <string>    // string
+#include <utility>   // make_pair, move, pair
+#include <vector>    // vector
+
+#include <fcntl.h>    // open, O_RDONLY
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+#include "Graph.h"
+#include "GraphIterators.h"
+
+// ---------------
+// csr_file_header
+// ---------------
+
+/**
+ * header of the binary CsrGraph format, followed by
+ * num_vertices + 1 uint64 offsets and then num_edges int32 targets, all in host byte order
+ * the header is a multiple of 8 bytes so the offsets stay aligned when the file is mapped
+ */
+struct csr_file_header {
+    char          magic[8];     // "CSRGRAPH"
+    std::uint32_t version;      // csr_file_version
+    std::uint32_t endian;       // csr_file_endian as written by the saving host
+    std::uint64_t num_vertices;
+    std::uint64_t num_edges;
+    std::uint64_t checksum;     // csr_checksum of offsets and targets
+};
+
+const char          csr_file_magic[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+const std::uint32_t csr_file_version  = 1;
+const std::uint32_t csr_file_endian   = 0x01020304;
+
+// ------------
+// csr_checksum
+// ------------
+
+/**
+ * @param o - n + 1 offsets
+ * @param n - number of vertices
+ * @param t - m targets
+ * @param m - number of edges
+ * @return 64-bit FNV-1a style hash, one multiply per array element
+ */
+inline std::uint64_t csr_checksum (const std::uint64_t* o, std::uint64_t n, const std::int32_t* t, std::uint64_t m) {
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t       h     = 14695981039346656037ULL;
+    for (std::uint64_t i = 0; i != n + 1; ++i)
+        h = (h ^ o[i]) * prime;
+    for (std::uint64_t i = 0; i != m; ++i)
+        h = (h ^ static_cast<std::uint32_t>(t[i])) * prime;
+    return h;}
+
+// --------
+// CsrGraph
+// --------
+
+/**
+ * immutable compressed sparse row snapshot of a Graph
+ * the out-edges of vertex u are _targets[_offsets[u], _offsets[u + 1]), sorted ascending
+ * so adjacency walks are sequential reads and edge lookups are binary searches
+ * the arrays are either owned vectors or pages of a mapped file; copies share them
+ */
+class CsrGraph {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef int vertex_descriptor;
+        typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
+
+        typedef std::size_t   vertices_size_type;
+        typedef std::size_t   edges_size_type;
+        typedef std::uint64_t offset_type;
+
+        typedef counting_iterator<vertex_descriptor>              vertex_iterator;
+        typedef csr_edge_iterator<vertex_descriptor, offset_type> edge_iterator;
+        typedef const vertex_descriptor*                          adjacency_iterator;
+
+        static_assert(sizeof(vertex_descriptor) == sizeof(std::int32_t), "targets are stored as int32");
+
+    public:
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * @param u - vertex descriptor
+         * @param g - constant reference to a CsrGraph
+         * @return pair of adjacency iterators from beginning to end of all vertices adjacent to u
+         */
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor u, const CsrGraph& g) {
+            adjacency_iterator b = g._targets + g._offsets[u];
+            adjacency_iterator e = g._targets + g._offsets[u + 1];
+            return std::make_pair(b, e);}
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * @param u - vertex descriptor
+         * @param v - vertex descriptor
+         * @param g - constant reference to a CsrGraph
+         * @return pair of edge_descriptor and boolean indicating if edge between u, v exists
+         * binary searches the row of u for v
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor u, vertex_descriptor v, const CsrGraph& g) {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(u, g);
+            adjacency_iterator i = std::lower_bound(p.first, p.second, v);
+            bool b = (i != p.second) && (*i == v);
+            return std::make_pair(std::make_pair(u, v), b);}
+
+        // -----
+        // edges
+        // -----
+
+        /**
+         * @param g - a constant reference to a CsrGraph
+         * @return a pair of edge_iterators to beginning and end of all edges in g, in source-major order
+         */
+        friend std::pair<edge_iterator, edge_iterator> edges (const CsrGraph& g) {
+            edge_iterator b(g._offsets, g._targets, g._n, 0);
+            edge_iterator e(g._offsets, g._targets, g._n, g._offsets[g._n]);
+            return std::make_pair(b, e);}
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * @param g - a constant reference to a CsrGraph
+         * @return edges_size_type - number of edges in g
+         */
+        friend edges_size_type num_edges (const CsrGraph& g) {
+            return static_cast<edges_size_type>(g._offsets[g._n]);}
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * @param g - a constant reference to a CsrGraph
+         * @return vertices_size_type - number of vertices in g
+         */
+        friend vertices_size_type num_vertices (const CsrGraph& g) {
+            return static_cast<vertices_size_type>(g._n);}
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * @param e - edge descriptor
+         * @param g - constant reference to a CsrGraph
+         * @return vertex_descriptor - the source of the edge e in g
+         */
+        friend vertex_descriptor source (edge_descriptor e, const CsrGraph&) {
+            return e.first;}
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * @param e - edge descriptor
+         * @param g - constant reference to a CsrGraph
+         * @return vertex_descriptor - the target of the edge e in g
+         */
+        friend vertex_descriptor target (edge_descriptor e, const CsrGraph&) {
+            return e.second;}
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * @param i - index of vertex i in g
+         * @param g - constant reference to a CsrGraph
+         * @return vertex_descriptor of vertex at index i in g
+         */
+        friend vertex_descriptor vertex (vertices_size_type i, const CsrGraph& g) {
+            assert(i < num_vertices(g));
+            return static_cast<vertex_descriptor>(i);}
+
+        // --------
+        // vertices
+        // --------
+
+        /**
+         * @param g - constant reference to a CsrGraph
+         * @return pair of vertex iterators to beginning and end of the vertices in g
+         * vertices are always 0..n-1, so the iterators are computed rather than stored
+         */
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const CsrGraph& g) {
+            vertex_iterator b(0);
+            vertex_iterator e(static_cast<vertex_descriptor>(num_vertices(g)));
+            return std::make_pair(b, e);}
+
+        // ------------
+        // memory_usage
+        // ------------
+
+        /**
+         * @param g - constant reference to a CsrGraph
+         * @return graph_memory - rows is the offsets array, adjacency the targets array
+         * counts the arrays whether they are owned or mapped from a file
+         */
+        friend graph_memory memory_usage (const CsrGraph& g) {
+            graph_memory m;
+            m.object    = sizeof(g);
+            m.rows      = (g._n + 1) * sizeof(offset_type);
+            m.adjacency = g._offsets[g._n] * sizeof(vertex_descriptor);
+            return m;}
+
+        // ----
+        // save
+        // ----
+
+        /**
+         * @param g    - constant reference to a CsrGraph
+         * @param path - file to create or overwrite
+         * writes g in the binary format described by csr_file_header
+         * throws std::runtime_error if the file cannot be written
+         */
+        friend void save (const CsrGraph& g, const std::string& path) {
+            csr_file_header h;
+            std::memcpy(h.magic, csr_file_magic, sizeof(h.magic));
+            h.version      = csr_file_version;
+            h.endian       = csr_file_endian;
+            h.num_vertices = g._n;
+            h.num_edges    = g._offsets[g._n];
+            h.checksum     = csr_checksum(g._offsets, g._n, g._targets, h.num_edges);
+
+            std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            out.write(reinterpret_cast<const char*>(g._offsets), (g._n + 1) * sizeof(offset_type));
+            out.write(reinterpret_cast<const char*>(g._targets), h.num_edges * sizeof(vertex_descriptor));
+            out.close();
+            if (!out)
+                throw std::runtime_error("CsrGraph: cannot write " + path);}
+
+    private:
+        // ----
+        // data
+        // ----
+
+        std::shared_ptr<const void> _storage; // keeps _offsets and _targets alive
+        const offset_type*          _offsets; // _n + 1 entries, _offsets[0] == 0
+        const vertex_descriptor*    _targets; // every row sorted, no duplicates
+        offset_type                 _n;
+
+        // ------
+        // arrays
+        // ------
+
+        /**
+         * owned storage of a CsrGraph built in memory
+         */
+        struct arrays {
+            std::vector<offset_type>       offsets;
+            std::vector<vertex_descriptor> targets;};
+
+        // -----
+        // unmap
+        // -----
+
+        /**
+         * deleter of the storage of a CsrGraph opened from a file
+         */
+        struct unmap {
+            std::size_t length;
+
+            void operator () (const void* p) const {
+                munmap(const_cast<void*>(p), length);}};
+
+        // -----------
+        // well_formed
+        // -----------
+
+        /**
+         * @param o - n + 1 offsets
+         * @param t - o[n] targets
+         * @param n - number of vertices, at most INT32_MAX
+         * @param m - number of targets t holds
+         * @return whether offsets start at 0, never decrease and end at m,
+         *         every row is strictly increasing and every target is a vertex
+         * an offset past m is caught before its row is read
+         */
+        static bool well_formed (const offset_type* o, const vertex_descriptor* t, offset_type n, offset_type m) {
+            if ((o[0] != 0) || (o[n] != m))
+                return false;
+            for (offset_type u = 0; u != n; ++u) {
+                if ((o[u] > o[u + 1]) || (o[u + 1] > m))
+                    return false;
+                for (offset_type i = o[u]; i != o[u + 1]; ++i) {
+                    if ((t[i] < 0) || (static_cast<offset_type>(t[i]) >= n))
+                        return false;
+                    if ((i != o[u]) && (t[i - 1] >= t[i]))
+                        return false;}}
+            return true;}
+
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return well_formed(_offsets, _targets, _n, _offsets[_n]);}
+
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * adopts arrays that live inside storage
+         */
+        CsrGraph (std::shared_ptr<const void> storage, const offset_type* offsets, const vertex_descriptor* targets, offset_type n) :
+                _storage (storage),
+                _offsets (offsets),
+                _targets (targets),
+                _n       (n) {
+            assert(valid());}
+
+    public:
+        /**
+         * @param offsets - n + 1 row offsets into targets
+         * @param targets - concatenated rows, each sorted ascending without duplicates
+         * the default is the empty graph
+         */
+        CsrGraph (std::vector<offset_type> offsets = std::vector<offset_type>(1, 0),
+                  std::vector<vertex_descriptor> targets = std::vector<vertex_descriptor>()) {
+            assert(!offsets.empty() && (offsets.back() == targets.size()));
+            std::shared_ptr<arrays> a = std::make_shared<arrays>();
+            a->offsets.swap(offsets);
+            a->targets.swap(targets);
+            _offsets = a->offsets.data();
+            _targets = a->targets.data();
+            _n       = a->offsets.size() - 1;
+            _storage = a;
+            assert(valid());}
+
+        // Default copy, destructor, and copy assignment
+        // CsrGraph  (const CsrGraph&);
+        // ~CsrGraph ();
+        // CsrGraph& operator = (const CsrGraph&);
+
+        // ----
+        // open
+        // ----
+
+        /**
+         * @param path   - file written by save
+         * @param verify - whether to recompute the checksum, which reads every page once
+         * @return CsrGraph whose arrays point straight into the read-only mapping of path
+         * throws std::runtime_error if the file cannot be mapped, is truncated, has the wrong
+         * magic, version or byte order, or, when verify is set, fails the checksum or has an
+         * offset out of order or past the targets, or a target that is not a vertex;
+         * without verify the offsets and targets are trusted
+         */
+        static CsrGraph open (const std::string& path, bool verify = true) {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("CsrGraph: cannot open " + path);
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("CsrGraph: cannot stat " + path);}
+            const std::size_t length = static_cast<std::size_t>(st.st_size);
+            if (length < sizeof(csr_file_header)) {
+                ::close(fd);
+                throw std::runtime_error("CsrGraph: truncated header in " + path);}
+            void* p = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED)
+                throw std::runtime_error("CsrGraph: cannot map " + path);
+
+            unmap d = {length};
+            std::shared_ptr<const void> storage(p, d);
+            const char*            base = static_cast<const char*>(p);
+            const csr_file_header* h    = reinterpret_cast<const csr_file_header*>(base);
+            if (std::memcmp(h->magic, csr_file_magic, sizeof(h->magic)) != 0)
+                throw std::runtime_error("CsrGraph: bad magic in " + path);
+            if (h->endian != csr_file_endian)
+                throw std::runtime_error("CsrGraph: byte order mismatch in " + path);
+            if (h->version != csr_file_version)
+                throw std::runtime_error("CsrGraph: unsupported version in " + path);
+            // bound both counts by the file before multiplying, so the sum below cannot wrap
+            const std::uint64_t body = length - sizeof(csr_file_header);
+            if ((h->num_vertices > static_cast<std::uint64_t>(INT32_MAX)) ||
+                (h->num_vertices >= body / sizeof(offset_type)) ||
+                (h->num_edges    >  body / sizeof(vertex_descriptor)))
+                throw std::runtime_error("CsrGraph: size mismatch in " + path);
+            const std::uint64_t expected = sizeof(csr_file_header)
+                                         + (h->num_vertices + 1) * sizeof(offset_type)
+                                         + h->num_edges * sizeof(vertex_descriptor);
+            if (expected != length)
+                throw std::runtime_error("CsrGraph: size mismatch in " + path);
+
+            const offset_type*       o = reinterpret_cast<const offset_type*>(base + sizeof(csr_file_header));
+            const vertex_descriptor* t = reinterpret_cast<const vertex_descriptor*>(o + h->num_vertices + 1);
+            if (verify && (csr_checksum(o, h->num_vertices, t, h->num_edges) != h->checksum))
+                throw std::runtime_error("CsrGraph: checksum mismatch in " + path);
+            if (o[h->num_vertices] != h->num_edges)
+                throw std::runtime_error("CsrGraph: bad offsets in " + path);
+            // the checksum is not keyed, so a file can match it and still index out of bounds
+            if (verify && !well_formed(o, t, h->num_vertices, h->num_edges))
+                throw std::runtime_error("CsrGraph: malformed rows in " + path);
+            return CsrGraph(storage, o, t, h->num_vertices);}
+    };
+
+// ------
+// freeze
+// ------
+
+/**
+ * @param g - constant reference to a Graph
+ * @return CsrGraph with the same vertices and edges as g
+ * packs every out-edge row of g into one contiguous target array, sorting the rows
+ * that OutEdgeS keeps in insertion order
+ */
+template <typename OutEdgeS, typename LayoutS>
+CsrGraph freeze (const BasicGraph<OutEdgeS, LayoutS>& g) {
+    typedef typename BasicGraph<OutEdgeS, LayoutS>::adjacency_iterator adjacency_iterator;
+    const std::size_t n = num_vertices(g);
+
+    std::vector<CsrGraph::offset_type> offsets;
+    offsets.reserve(n + 1);
+    offsets.push_back(0);
+    std::vector<CsrGraph::vertex_descriptor> targets;
+    targets.reserve(num_edges(g));
+
+    for (std::size_t u = 0; u != n; ++u) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex(u, g), g);
+        targets.insert(targets.end(), p.first, p.second);
+        if (!std::is_sorted(targets.begin() + offsets.back(), targets.end()))
+            std::sort(targets.begin() + offsets.back(), targets.end());
+        offsets.push_back(targets.size());}
+
+    return CsrGraph(std::move(offsets), std::move(targets));}
+
+// ----
+// save
+// ----
+
+/**
+ * @param g    - constant reference to a Graph
+ * @param path - file to create or overwrite
+ * writes freeze(g) so the file can later be opened with CsrGraph::open
+ */
+template <typename OutEdgeS, typename LayoutS>
+void save (const BasicGraph<OutEdgeS, LayoutS>& g, const std::string& path) {
+    save(freeze(g), path);}
+
+#endif // CsrGraph_h
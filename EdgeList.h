@@ -0,0 +1,291 @@
+// -------------------------
+// projects/graph/EdgeList.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// -------------------------
+
+#ifndef EdgeList_h
+#define EdgeList_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound, max, sort, unique
+#include <chrono>    // steady_clock
+#include <cstddef>   // size_t
+#include <cstdint>   // int64_t, uint64_t
+#include <exception> // current_exception, exception_ptr, make_exception_ptr, rethrow_exception
+#include <limits>    // numeric_limits
+#include <memory>    // shared_ptr
+#include <sstream>   // ostringstream
+#include <stdexcept> // runtime_error
+#include <string>    // string
+#include <thread>    // thread
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include <fcntl.h>    // open, O_RDONLY
+#include <sys/mman.h> // madvise, mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+#include "Graph.h"
+
+// -----------------
+// edge_list_options
+// -----------------
+
+/**
+ * how read_edge_list splits and interprets its input
+ */
+struct edge_list_options {
+    unsigned threads; // 0 uses std::thread::hardware_concurrency()
+    bool     remap;   // map arbitrary ids onto 0..n-1 in ascending id order
+
+    edge_list_options () :
+            threads (0),
+            remap   (false)
+        {}};
+
+// ---------------
+// edge_list_stats
+// ---------------
+
+/**
+ * what read_edge_list did
+ */
+struct edge_list_stats {
+    std::size_t               bytes;      // size of the input
+    std::size_t               edges;      // edge lines parsed, duplicates included
+    std::size_t               duplicates; // edges dropped by add_edges
+    unsigned                  threads;    // chunks parsed in parallel
+    double                    seconds;    // wall time of parse and build
+    std::vector<std::int64_t> ids;        // with remap, ids[v] is the original id of vertex v
+
+    edge_list_stats () :
+            bytes      (0),
+            edges      (0),
+            duplicates (0),
+            threads    (0),
+            seconds    (0)
+        {}
+
+    /**
+     * @return input throughput in megabytes (10^6 bytes) per second
+     */
+    double mb_per_second () const {
+        return (seconds > 0) ? (bytes / 1e6) / seconds : 0;}};
+
+// ----------------
+// edge_list_detail
+// ----------------
+
+namespace edge_list_detail {
+
+typedef std::pair<std::int64_t, std::int64_t> raw_edge;
+
+/**
+ * @param p - parse position
+ * @param e - end of the chunk
+ * moves p past spaces, tabs and carriage returns
+ */
+inline void skip_blanks (const char*& p, const char* e) {
+    while ((p != e) && ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+        ++p;}
+
+/**
+ * @param p - parse position
+ * @param e - end of the chunk
+ * @param x - the parsed value
+ * @return whether an optionally signed decimal integer started at p
+ */
+inline bool parse_int (const char*& p, const char* e, std::int64_t& x) {
+    bool negative = false;
+    if ((p != e) && ((*p == '-') || (*p == '+'))) {
+        negative = (*p == '-');
+        ++p;}
+    if ((p == e) || (*p < '0') || (*p > '9'))
+        return false;
+    std::uint64_t v = 0;
+    while ((p != e) && (*p >= '0') && (*p <= '9')) {
+        if (v > 922337203685477579ULL)
+            return false;
+        v = v * 10 + static_cast<std::uint64_t>(*p - '0');
+        ++p;}
+    x = negative ? -static_cast<std::int64_t>(v) : static_cast<std::int64_t>(v);
+    return true;}
+
+/**
+ * @param b    - first character of the chunk, at the start of a line
+ * @param e    - end of the chunk, just past a newline or at the end of the input
+ * @param base - start of the whole input, for error messages
+ * @param out  - receives one pair per edge line
+ * skips blank lines and lines whose first non-blank character is '#' or '%'
+ * columns after the second on a line, such as weights or timestamps, are ignored
+ */
+inline void parse_chunk (const char* b, const char* e, const char* base, std::vector<raw_edge>& out) {
+    const char* p = b;
+    while (p != e) {
+        skip_blanks(p, e);
+        if ((p != e) && (*p != '\n') && (*p != '#') && (*p != '%')) {
+            const char*  line = p;
+            std::int64_t u;
+            std::int64_t v;
+            bool ok = parse_int(p, e, u);
+            if (ok) {
+                skip_blanks(p, e);
+                ok = parse_int(p, e, v);}
+            if (!ok) {
+                std::ostringstream s;
+                s << "read_edge_list: malformed line at byte " << (line - base);
+                throw std::runtime_error(s.str());}
+            out.push_back(std::make_pair(u, v));}
+        while ((p != e) && (*p != '\n'))
+            ++p;
+        if (p != e)
+            ++p;}}
+
+/**
+ * @param b - start of the input
+ * @param e - end of the input
+ * @param k - number of chunks wanted
+ * @return k + 1 boundaries, each just past a newline, so no line is split
+ */
+inline std::vector<const char*> split (const char* b, const char* e, unsigned k) {
+    std::vector<const char*> cuts(1, b);
+    const std::size_t size = e - b;
+    for (unsigned i = 1; i < k; ++i) {
+        const char* p = std::max(cuts.back(), b + size / k * i);
+        while ((p != e) && (p != b) && (p[-1] != '\n'))
+            ++p;
+        cuts.push_back(p);}
+    cuts.push_back(e);
+    return cuts;}
+
+}
+
+// --------------
+// read_edge_list
+// --------------
+
+/**
+ * @param b     - start of whitespace separated "u v" text, one edge per line
+ * @param e     - end of the text
+ * @param opts  - thread count and id remapping
+ * @param stats - if not null, receives sizes, timing and the remapped ids
+ * @return Graph holding every edge of the text
+ * splits the text on line boundaries, parses the chunks on separate threads without
+ * iostreams and hands the merged edges to add_edges in one batch
+ * without remap every id must already be a vertex_descriptor below INT_MAX
+ * throws std::runtime_error on a malformed line or an id that does not fit
+ */
+inline Graph read_edge_list (const char* b, const char* e, const edge_list_options& opts = edge_list_options(), edge_list_stats* stats = 0) {
+    using namespace edge_list_detail;
+    typedef Graph::vertex_descriptor vertex_descriptor;
+    typedef Graph::edge_descriptor   edge_descriptor;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const unsigned k = (opts.threads != 0) ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    const std::vector<const char*>     cuts = split(b, e, k);
+    std::vector<std::vector<raw_edge> > parts(k);
+    std::vector<std::exception_ptr>     errors(k);
+    std::vector<std::thread>            workers;
+    for (unsigned i = 0; i != k; ++i)
+        workers.push_back(std::thread([&, i] () {
+            try {
+                parts[i].reserve((cuts[i + 1] - cuts[i]) / 8);
+                parse_chunk(cuts[i], cuts[i + 1], b, parts[i]);}
+            catch (...) {
+                errors[i] = std::current_exception();}}));
+    for (unsigned i = 0; i != k; ++i)
+        workers[i].join();
+    for (unsigned i = 0; i != k; ++i)
+        if (errors[i])
+            std::rethrow_exception(errors[i]);
+
+    std::size_t m = 0;
+    for (unsigned i = 0; i != k; ++i)
+        m += parts[i].size();
+
+    std::vector<std::int64_t> ids;
+    if (opts.remap) {
+        ids.reserve(2 * m);
+        for (unsigned i = 0; i != k; ++i)
+            for (std::size_t j = 0; j != parts[i].size(); ++j) {
+                ids.push_back(parts[i][j].first);
+                ids.push_back(parts[i][j].second);}
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        if (ids.size() > static_cast<std::size_t>(std::numeric_limits<vertex_descriptor>::max()))
+            throw std::runtime_error("read_edge_list: too many distinct ids");}
+
+    std::vector<edge_descriptor> batch(m);
+    std::vector<std::size_t>     first(k + 1, 0);
+    for (unsigned i = 0; i != k; ++i)
+        first[i + 1] = first[i] + parts[i].size();
+    workers.clear();
+    for (unsigned i = 0; i != k; ++i)
+        workers.push_back(std::thread([&, i] () {
+            const std::int64_t top = std::numeric_limits<vertex_descriptor>::max();
+            for (std::size_t j = 0; j != parts[i].size(); ++j) {
+                std::int64_t u = parts[i][j].first;
+                std::int64_t v = parts[i][j].second;
+                if (opts.remap) {
+                    u = std::lower_bound(ids.begin(), ids.end(), u) - ids.begin();
+                    v = std::lower_bound(ids.begin(), ids.end(), v) - ids.begin();}
+                else if ((u < 0) || (v < 0) || (u >= top) || (v >= top)) {
+                    errors[i] = std::make_exception_ptr(std::runtime_error("read_edge_list: id out of range, use remap"));
+                    return;}
+                batch[first[i] + j] = std::make_pair(static_cast<vertex_descriptor>(u), static_cast<vertex_descriptor>(v));}
+            std::vector<raw_edge>().swap(parts[i]);}));
+    for (unsigned i = 0; i != k; ++i)
+        workers[i].join();
+    for (unsigned i = 0; i != k; ++i)
+        if (errors[i])
+            std::rethrow_exception(errors[i]);
+
+    Graph g;
+    const std::size_t duplicates = add_edges(batch.begin(), batch.end(), g);
+
+    if (stats != 0) {
+        stats->bytes      = e - b;
+        stats->edges      = m;
+        stats->duplicates = duplicates;
+        stats->threads    = k;
+        stats->seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats->ids.swap(ids);}
+    return g;}
+
+/**
+ * @param path  - edge list file, e.g. in SNAP format
+ * @param opts  - thread count and id remapping
+ * @param stats - if not null, receives sizes, timing and the remapped ids
+ * @return Graph holding every edge of the file
+ * maps the file read-only and parses it in place
+ * throws std::runtime_error if the file cannot be read or is malformed
+ */
+inline Graph read_edge_list (const std::string& path, const edge_list_options& opts = edge_list_options(), edge_list_stats* stats = 0) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("read_edge_list: cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("read_edge_list: cannot stat " + path);}
+    const std::size_t length = static_cast<std::size_t>(st.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return read_edge_list(static_cast<const char*>(0), static_cast<const char*>(0), opts, stats);}
+    void* p = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw std::runtime_error("read_edge_list: cannot map " + path);
+    madvise(p, length, MADV_SEQUENTIAL);
+
+    std::shared_ptr<void> guard(p, [length] (void* q) {munmap(q, length);});
+    const char* b = static_cast<const char*>(p);
+    return read_edge_list(b, b + length, opts, stats);}
+
+#endif // EdgeList_h
@@ -11,27 +11,42 @@
 // includes
 // --------
 
-#include <cassert> // assert
-#include <cstddef> // size_t
-#include <utility> // make_pair, pair
-#include <vector>  // vector
-
-// -----
-// Graph
-// -----
-
-class Graph {
+#include <algorithm> // max, min, sort, unique
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <limits>    // numeric_limits
+#include <stdexcept> // length_error
+#include <utility>   // make_pair, move, pair
+#include <vector>    // vector
+
+#include "GraphLayout.h"
+#include "OutEdgeStorage.h"
+
+// ----------
+// BasicGraph
+// ----------
+
+/**
+ * directed graph whose vertices are 0..n-1
+ * OutEdgeS selects the container of each vertex's out-edges, see OutEdgeStorage.h
+ * LayoutS selects whether vertex and edge lists are stored or computed, see GraphLayout.h
+ */
+template <typename OutEdgeS = ordered_setS, typename LayoutS = indexedS>
+class BasicGraph {
     public:
         // --------
         // typedefs
         // --------
 
-        typedef int vertex_descriptor;
+        typedef typename LayoutS::vertex_descriptor vertex_descriptor;
         typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
 
-       typedef std::vector<vertex_descriptor>::const_iterator vertex_iterator;
-        typedef std::vector<edge_descriptor>::const_iterator edge_iterator;
-        typedef std::set<vertex_descriptor>::iterator adjacency_iterator;
+        typedef typename out_edge_row<OutEdgeS, vertex_descriptor>::type row_type;
+        typedef graph_layout<LayoutS, row_type> layout_type;
+
+        typedef typename layout_type::vertex_iterator vertex_iterator;
+        typedef typename layout_type::edge_iterator edge_iterator;
+        typedef typename row_type::const_iterator adjacency_iterator;
 
         typedef std::size_t vertices_size_type;
         typedef std::size_t edges_size_type;
@@ -47,30 +62,58 @@ class Graph {
          * @param g - reference to a graph
          * @return pair of edge_descriptor and boolean indicating whether creation of edge was successful
          * attempts to add an edge between vertex u and vertex v to Graph g
+         * grows g in one step when u or v is not yet a vertex
+         * throws std::length_error, leaving g unchanged, if g would exceed max_vertices()
          */
-        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor u, vertex_descriptor v, Graph& g) {
-            int graph_size = (int)g._vertices.size();
+        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor u, vertex_descriptor v, BasicGraph& g) {
+            assert(!(u < vertex_descriptor()) && !(v < vertex_descriptor()));
+            g.grow(static_cast<vertices_size_type>(std::max(u, v)) + 1);
 
             edge_descriptor ed = std::make_pair(u,v);
-            if(graph_size > u){
-                if(graph_size > v){
-                    std::pair<adjacency_iterator, bool> uv = g._adjacents[u].insert(v);
-                    if(uv.second){
-                        g._edges.push_back(ed);
-                    }
-                    else
-                        return std::make_pair(ed, false);
-                }else{
-                    for(vertex_descriptor i = graph_size; i <= v; ++i){
-                        g._vertices.push_back(i);
-                        g._adjacents.push_back(std::set<vertex_descriptor>());
-                    }
-                    return add_edge(u, v, g);
-                }
-            }
-
+            if(!g._adjacents[u].insert(v))
+                return std::make_pair(ed, false);
+            g._layout.added(ed);
             return std::make_pair(ed, true);}
 
+        // ---------
+        // add_edges
+        // ---------
+
+        /**
+         * @param b - input iterator to the first edge_descriptor
+         * @param e - input iterator past the last edge_descriptor
+         * @param g - reference to a graph
+         * @return edges_size_type - number of edges in [b, e) that were dropped as duplicates
+         * adds every edge in [b, e) to g, giving the same graph as calling add_edge on each of them
+         * the batch is sorted and deduplicated once and g is grown once, so each row is
+         * filled in ascending order and every row insertion is an amortized O(1) append
+         * edges() lists the new edges in sorted order rather than in the order of [b, e)
+         * throws std::length_error, leaving g unchanged, if g would exceed max_vertices()
+         */
+        template <typename II>
+        friend edges_size_type add_edges (II b, II e, BasicGraph& g) {
+            std::vector<edge_descriptor> batch(b, e);
+            const edges_size_type given = batch.size();
+            if (batch.empty())
+                return 0;
+
+            std::sort(batch.begin(), batch.end());
+            batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+
+            vertices_size_type n = 0;
+            for (typename std::vector<edge_descriptor>::const_iterator i = batch.begin(); i != batch.end(); ++i) {
+                assert(!(i->first < vertex_descriptor()) && !(i->second < vertex_descriptor()));
+                n = std::max(n, static_cast<vertices_size_type>(std::max(i->first, i->second)) + 1);}
+            g.grow(n);
+            g._layout.reserve_edges(batch.size());
+
+            edges_size_type added = 0;
+            for (typename std::vector<edge_descriptor>::const_iterator i = batch.begin(); i != batch.end(); ++i) {
+                if (g._adjacents[i->first].append(i->second)) {
+                    g._layout.added(*i);
+                    ++added;}}
+            return given - added;}
+
         // ----------
         // add_vertex
         // ----------
@@ -79,11 +122,11 @@ class Graph {
          * @param g reference to a Graph
          * @return vertex_descriptor
          * adds a vertex, v, to g and returns v
+         * throws std::length_error, leaving g unchanged, if g would exceed max_vertices()
          */
-        friend vertex_descriptor add_vertex (Graph& g) {
-            vertex_descriptor v = g._vertices.size();
-            g._vertices.push_back(v);
-            g._adjacents.push_back(std::set<vertex_descriptor>());
+        friend vertex_descriptor add_vertex (BasicGraph& g) {
+            vertex_descriptor v = static_cast<vertex_descriptor>(g._adjacents.size());
+            g.grow(g._adjacents.size() + 1);
             return v;}
 
 
@@ -96,7 +139,7 @@ class Graph {
          * @param g - constant reference to a Graph
          * returns pair of adjacency iterators from beginning to end of all vertices adjacent to u
          */
-        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor u, const Graph& g) {
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor u, const BasicGraph& g) {
             adjacency_iterator b = g._adjacents[u].begin();
             adjacency_iterator e = g._adjacents[u].end();
             return std::make_pair(b, e);}
@@ -112,9 +155,9 @@ class Graph {
          * @return pair of edge_descriptor and boolean indicating if edge between u, v exists
          * checks whether the graph contains an edge from u to v
          */
-        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor u, vertex_descriptor v, const Graph& g) {
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor u, vertex_descriptor v, const BasicGraph& g) {
             edge_descriptor ed = std::make_pair(u, v);
-            bool b = (g._adjacents[u].find(v) != g._adjacents[u].end());
+            bool b = g._adjacents[u].contains(v);
             return std::make_pair(ed, b);}
 
         // -----
@@ -125,11 +168,10 @@ class Graph {
          * @param g - a constant reference to a Graph
          * @return a pair of edge_iterators to beginning and end of all edges in g
          * returns edge_iterators to beginning and end of all edges in a Graph
+         * in insertion order under indexedS, in source-major row order under compactS
          */
-        friend std::pair<edge_iterator, edge_iterator> edges (const Graph& g) {
-            edge_iterator b = g._edges.begin();
-            edge_iterator e = g._edges.end();
-            return std::make_pair(b, e);}
+        friend std::pair<edge_iterator, edge_iterator> edges (const BasicGraph& g) {
+            return g._layout.edges(g._adjacents);}
 
         // ---------
         // num_edges
@@ -140,8 +182,8 @@ class Graph {
          * @return edges_size_type - number of edges in g
          * returns the number of edges in a Graph
          */
-        friend edges_size_type num_edges (const Graph& g) {
-            edges_size_type s = (edges_size_type) g._edges.size();
+        friend edges_size_type num_edges (const BasicGraph& g) {
+            edges_size_type s = (edges_size_type) g._layout.num_edges(g._adjacents);
             return s;}
         // ------------
         // num_vertices
@@ -152,8 +194,8 @@ class Graph {
          * @return vertices_size_type - number of vertices in g
          * returns the number of vertices in a Graph
          */
-        friend vertices_size_type num_vertices (const Graph& g) {
-            vertices_size_type s = (vertices_size_type) g._vertices.size();
+        friend vertices_size_type num_vertices (const BasicGraph& g) {
+            vertices_size_type s = (vertices_size_type) g._adjacents.size();
             return s;}
 
         // ------
@@ -166,7 +208,7 @@ class Graph {
          * @return vertex_descriptor
          * returns vertex that is the source of the edge e in g
          */
-        friend vertex_descriptor source (edge_descriptor e, const Graph& g) {
+        friend vertex_descriptor source (edge_descriptor e, const BasicGraph& g) {
             vertex_descriptor v = e.first;
             // assert(g._adjacents[v].find(e.second) != g._adjacents[v].end());
             return v;}
@@ -181,7 +223,7 @@ class Graph {
          * @return vertex_descriptor
          * returns vertex that is the target in edge e in graph g
          */
-        friend vertex_descriptor target (edge_descriptor e, const Graph& g) {
+        friend vertex_descriptor target (edge_descriptor e, const BasicGraph& g) {
             vertex_descriptor v = e.second;
             // assert(g._adjacents[v].find(e.second) != g._adjacents[v].end());
             return v;}
@@ -196,8 +238,8 @@ class Graph {
          * @return vertex_descriptor
          * returns vertex descriptor of vertex at index i in g
          */
-        friend vertex_descriptor vertex (vertices_size_type i, const Graph& g) {
-            vertex_descriptor vd = g._vertices[i];
+        friend vertex_descriptor vertex (vertices_size_type i, const BasicGraph& g) {
+            vertex_descriptor vd = g._layout.vertex(i);
             return vd;}
         // --------
         // vertices
@@ -208,18 +250,33 @@ class Graph {
          * @return pair of vertex iterators
          * returns beginning and end vertex_iterator for vertices in g
          */
-        friend std::pair<vertex_iterator, vertex_iterator> vertices (const Graph& g) {
-            vertex_iterator b = g._vertices.begin();
-            vertex_iterator e = g._vertices.end();
-            return std::make_pair(b, e);}
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const BasicGraph& g) {
+            return g._layout.vertices(g._adjacents);}
+
+        // ------------
+        // memory_usage
+        // ------------
+
+        /**
+         * @param g - constant reference to a Graph
+         * @return graph_memory - bytes held by g, by component
+         * container capacities are counted, std::set nodes are estimated
+         */
+        friend graph_memory memory_usage (const BasicGraph& g) {
+            graph_memory m;
+            m.object = sizeof(g);
+            m.rows   = g._adjacents.capacity() * sizeof(row_type);
+            for (typename std::vector<row_type>::const_iterator i = g._adjacents.begin(); i != g._adjacents.end(); ++i)
+                m.adjacency += i->heap_bytes();
+            g._layout.memory(m);
+            return m;}
     private:
         // ----
         // data
         // ----
 
-        std::vector< std::set<vertex_descriptor> > _adjacents; // set to not allow duplicates
-        std::vector<vertex_descriptor> _vertices;
-        std::vector<edge_descriptor> _edges;
+        std::vector<row_type> _adjacents; // rows do not allow duplicates
+        layout_type _layout;              // vertex and edge lists, if LayoutS stores them
 
         // -----
         // valid
@@ -229,24 +286,64 @@ class Graph {
          * <your documentation>
          */
         bool valid () const {
-            assert(_vertices.size() == _adjacents.size());
+            assert(_layout.valid(_adjacents));
             return true;}
 
+        // ----
+        // grow
+        // ----
+
+        /**
+         * @param n - number of vertices g must have afterwards
+         * adds the vertices num_vertices(g)..n-1 in one step; never shrinks
+         */
+        void grow (vertices_size_type n) {
+            vertices_size_type s = _adjacents.size();
+            if (n <= s)
+                return;
+            if (n > max_vertices())
+                throw std::length_error("BasicGraph: more vertices than vertex_descriptor can number");
+            _layout.grow(s, n);
+            _adjacents.resize(n);}
+
     public:
+        // ------------
+        // max_vertices
+        // ------------
+
+        /**
+         * @return most vertices a graph of this type can hold
+         * the count itself must fit in vertex_descriptor, since vertices() ends at it,
+         * and every id must be a target the rows can store
+         */
+        static vertices_size_type max_vertices () {
+            const vertices_size_type ids  = static_cast<vertices_size_type>(std::numeric_limits<vertex_descriptor>::max());
+            const vertices_size_type rows = static_cast<vertices_size_type>(row_type::max_target()) + 1;
+            return std::min(ids, rows);}
+
         // ------------
         // constructors
         // ------------
 
         /**
          * Default Constructor for Graph
+         * @param adj - one row per vertex; the vertex and edge lists are derived from it
          */
-        Graph (std::vector<std::set<vertex_descriptor> > adj = std::vector<std::set<vertex_descriptor> >(),
-                std::vector<vertex_descriptor> vert = std::vector<vertex_descriptor>(),
-                std::vector<edge_descriptor> ed = std::vector<edge_descriptor>()):
-            _adjacents(adj),
-            _vertices(vert),
-            _edges(ed){
-            // <your code>
+        BasicGraph (std::vector<row_type> adj = std::vector<row_type>()):
+            _adjacents(std::move(adj)){
+            if (_adjacents.size() > max_vertices())
+                throw std::length_error("BasicGraph: more vertices than vertex_descriptor can number");
+            _layout.rebuild(_adjacents);
+            assert(valid());}
+
+        /**
+         * @param b - input iterator to the first edge_descriptor
+         * @param e - input iterator past the last edge_descriptor
+         * builds a Graph from an edge range through add_edges
+         */
+        template <typename II>
+        BasicGraph (II b, II e) {
+            add_edges(b, e, *this);
             assert(valid());}
 
 
@@ -256,4 +353,19 @@ class Graph {
         // Graph& operator = (const Graph&);
     };
 
+// -----
+// Graph
+// -----
+
+typedef BasicGraph<> Graph;
+
+// ------------
+// CompactGraph
+// ------------
+
+/**
+ * Graph without stored vertex or edge lists and with sorted, inline-first rows
+ */
+typedef BasicGraph<small_vectorS<>, compactS<> > CompactGraph;
+
 #endif // Graph_h
\ No newline at end of file
@@ -0,0 +1,582 @@
+// --------------------------------
+// projects/graph/GraphAlgorithms.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef GraphAlgorithms_h
+#define GraphAlgorithms_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm>   // copy, find, is_sorted, min, sort, unique
+#include <atomic>      // atomic, memory_order
+#include <cassert>     // assert
+#include <cstddef>     // size_t
+#include <cstdint>     // int32_t, uint64_t, INT32_MAX
+#include <iterator>    // distance
+#include <memory>      // unique_ptr
+#include <type_traits> // false_type, integral_constant, is_same, true_type
+#include <utility>     // make_pair, pair
+#include <vector>      // vector
+
+#include "Intersection.h"
+#include "ThreadPool.h"
+
+// The algorithms below only use num_vertices and adjacent_vertices, so they run on
+// Graph, CsrGraph and boost::adjacency_list<*, vecS, directedS> alike. Boost defines
+// functions of the same names, so call them as ::topological_sort and ::breadth_first_search
+// when g is a Boost graph to keep argument-dependent lookup out of it.
+// Vertex ids must fit in int32_t for common_neighbors, count_triangles and local_clustering.
+// The overloads without a ThreadPool run on default_pool(), which the whole process shares;
+// calls from different threads take turns on it, so pass each thread its own pool to overlap them.
+
+// -----------------------
+// topological_sort_result
+// -----------------------
+
+/**
+ * order    - the vertices Kahn's algorithm could place, level by level, ascending within a level
+ * unplaced - the vertices it could not place: every vertex on a cycle and every vertex reachable from one
+ * cyclic   - the unplaced vertices that lie on a cycle, ascending; breaking the edges among them
+ *            is what makes g a DAG
+ */
+template <typename V>
+struct topological_sort_result {
+    std::vector<V> order;
+    std::vector<V> unplaced;
+    std::vector<V> cyclic;
+
+    bool is_dag () const {
+        return cyclic.empty();}};
+
+// -----------------
+// algorithms_detail
+// -----------------
+
+namespace algorithms_detail {
+
+/**
+ * @param o - n + 1 row offsets into t
+ * @param t - targets, each less than n
+ * @return for each vertex, whether it lies on a cycle: its strongly connected component
+ *         has more than one vertex or it has an edge to itself
+ * Tarjan's algorithm with an explicit stack, so deep graphs cannot overflow the call stack
+ */
+inline std::vector<bool> on_cycle (const std::vector<std::size_t>& o, const std::vector<std::size_t>& t) {
+    const std::size_t n    = o.size() - 1;
+    const std::size_t none = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> index(n, none);
+    std::vector<std::size_t> low(n);
+    std::vector<bool>        stacked(n, false);
+    std::vector<bool>        r(n, false);
+    std::vector<std::size_t> component;
+    std::vector<std::pair<std::size_t, std::size_t> > calls; // vertex, next edge to follow
+    std::size_t              counter = 0;
+
+    for (std::size_t s = 0; s != n; ++s) {
+        if (index[s] != none)
+            continue;
+        index[s] = low[s] = counter++;
+        component.push_back(s);
+        stacked[s] = true;
+        calls.push_back(std::make_pair(s, o[s]));
+        while (!calls.empty()) {
+            const std::size_t u = calls.back().first;
+            if (calls.back().second != o[u + 1]) {
+                const std::size_t v = t[calls.back().second++];
+                if (index[v] == none) {
+                    index[v] = low[v] = counter++;
+                    component.push_back(v);
+                    stacked[v] = true;
+                    calls.push_back(std::make_pair(v, o[v]));}
+                else if (stacked[v])
+                    low[u] = std::min(low[u], index[v]);
+                continue;}
+            calls.pop_back();
+            if (!calls.empty())
+                low[calls.back().first] = std::min(low[calls.back().first], low[u]);
+            if (low[u] != index[u])
+                continue;
+            const bool loop = std::find(t.begin() + o[u], t.begin() + o[u + 1], u) != t.begin() + o[u + 1];
+            const bool many = component.back() != u;
+            std::size_t v;
+            do {
+                v = component.back();
+                component.pop_back();
+                stacked[v] = false;
+                r[v]       = many || loop;}
+            while (v != u);}}
+    return r;}
+
+} // algorithms_detail
+
+// ----------------
+// topological_sort
+// ----------------
+
+/**
+ * @param g    - constant reference to a directed graph
+ * @param pool - threads to run on
+ * @return topological_sort_result; for a DAG order holds every vertex and each edge u -> v has u before v
+ * level-synchronous Kahn's algorithm: in-degrees are atomic counters, every level is
+ * expanded in parallel and the vertex whose counter reaches zero joins the next level;
+ * if vertices are left over, the strongly connected components of the subgraph they
+ * induce tell the ones on a cycle from the ones merely downstream of one
+ */
+template <typename G>
+topological_sort_result<typename G::vertex_descriptor> topological_sort (const G& g, ThreadPool& pool) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t                    n = num_vertices(g);
+    const std::size_t                    grain = 1024;
+    std::unique_ptr<std::atomic<int>[]>  indegree(new std::atomic<int>[n]);
+    std::vector<std::vector<vertex_descriptor> > local(pool.size());
+    topological_sort_result<vertex_descriptor> r;
+
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u)
+            indegree[u].store(0, std::memory_order_relaxed);});
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u) {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+            for (; p.first != p.second; ++p.first)
+                indegree[*p.first].fetch_add(1, std::memory_order_relaxed);}});
+
+    // the zero in-degree vertices are found in parallel, then merged and sorted
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned id) {
+        for (std::size_t u = b; u != e; ++u)
+            if (indegree[u].load(std::memory_order_relaxed) == 0)
+                local[id].push_back(static_cast<vertex_descriptor>(u));});
+
+    r.order.reserve(n);
+    std::size_t first = 0;
+    for (;;) {
+        for (std::size_t i = 0; i != local.size(); ++i) {
+            r.order.insert(r.order.end(), local[i].begin(), local[i].end());
+            local[i].clear();}
+        if (first == r.order.size())
+            break;
+        std::sort(r.order.begin() + first, r.order.end());
+        const std::size_t last = r.order.size();
+        pool.parallel_for(first, last, 64, [&] (std::size_t b, std::size_t e, unsigned id) {
+            for (std::size_t i = b; i != e; ++i) {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(r.order[i], g);
+                for (; p.first != p.second; ++p.first)
+                    if (indegree[*p.first].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        local[id].push_back(*p.first);}});
+        first = last;}
+
+    if (r.order.size() == n)
+        return r;
+    const std::size_t        none = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> local_id(n, none);
+    for (std::size_t u = 0; u != n; ++u)
+        if (indegree[u].load(std::memory_order_relaxed) != 0) {
+            local_id[u] = r.unplaced.size();
+            r.unplaced.push_back(static_cast<vertex_descriptor>(u));}
+
+    // the subgraph induced by the unplaced vertices, renumbered 0..k-1
+    std::vector<std::size_t> offsets(1, 0);
+    std::vector<std::size_t> targets;
+    for (std::size_t i = 0; i != r.unplaced.size(); ++i) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(r.unplaced[i], g);
+        for (; p.first != p.second; ++p.first)
+            if (local_id[*p.first] != none)
+                targets.push_back(local_id[*p.first]);
+        offsets.push_back(targets.size());}
+    const std::vector<bool> cycle = algorithms_detail::on_cycle(offsets, targets);
+    for (std::size_t i = 0; i != r.unplaced.size(); ++i)
+        if (cycle[i])
+            r.cyclic.push_back(r.unplaced[i]);
+    return r;}
+
+/**
+ * @param g - constant reference to a directed graph
+ * @return topological_sort(g, default_pool())
+ */
+template <typename G>
+topological_sort_result<typename G::vertex_descriptor> topological_sort (const G& g) {
+    return topological_sort(g, default_pool());}
+
+// ----------
+// bfs_result
+// ----------
+
+/**
+ * distance         - number of edges on a shortest path from the source, -1 if unreachable
+ * parent           - predecessor on one such path; the source and unreachable vertices are their own parent
+ * bottom_up_levels - how many levels were expanded bottom-up
+ */
+template <typename V>
+struct bfs_result {
+    std::vector<int> distance;
+    std::vector<V>   parent;
+    unsigned         bottom_up_levels;};
+
+// --------------------
+// breadth_first_search
+// --------------------
+
+/**
+ * @param g     - constant reference to a directed graph
+ * @param s     - source vertex, less than num_vertices(g) unless g is empty
+ * @param pool  - threads to run on
+ * @param alpha - switch to bottom-up once the frontier's out-edges exceed the unexplored edges / alpha
+ * @param beta  - switch back to top-down once the frontier holds fewer than n / beta vertices
+ * @return bfs_result, empty when g has no vertices
+ * direction-optimizing BFS: small frontiers push along their out-edges (top-down), large
+ * frontiers are found by letting every unvisited vertex look for a parent among its
+ * in-edges (bottom-up); the in-edges are built on the first bottom-up level
+ */
+template <typename G>
+bfs_result<typename G::vertex_descriptor> breadth_first_search (const G& g, typename G::vertex_descriptor s, ThreadPool& pool, double alpha = 14, double beta = 24) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t                   n = num_vertices(g);
+    const std::size_t                   grain = 1024;
+    if (n == 0) {
+        bfs_result<vertex_descriptor> r;
+        r.bottom_up_levels = 0;
+        return r;}
+    assert(static_cast<std::size_t>(s) < n);
+    std::unique_ptr<std::atomic<int>[]> distance(new std::atomic<int>[n]);
+    std::vector<vertex_descriptor>      parent(n);
+    std::vector<std::size_t>            degree(n);
+    std::vector<std::vector<vertex_descriptor> > local(pool.size());
+    std::vector<std::size_t>            local_edges(pool.size());
+    std::vector<std::size_t>            in_offsets; // in-edge CSR, built on demand
+    std::vector<vertex_descriptor>      in_sources;
+
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u) {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+            distance[u].store(-1, std::memory_order_relaxed);
+            parent[u] = static_cast<vertex_descriptor>(u);
+            degree[u] = static_cast<std::size_t>(std::distance(p.first, p.second));}});
+    std::size_t m = 0;
+    for (std::size_t u = 0; u != n; ++u)
+        m += degree[u];
+
+    bfs_result<vertex_descriptor> r;
+    r.bottom_up_levels = 0;
+    std::vector<vertex_descriptor> frontier(1, s);
+    distance[s].store(0, std::memory_order_relaxed);
+    std::size_t frontier_edges   = degree[s];
+    std::size_t unexplored_edges = m - degree[s];
+    bool        bottom_up        = false;
+
+    for (int level = 0; !frontier.empty(); ++level) {
+        if (!bottom_up && (frontier_edges > unexplored_edges / alpha))
+            bottom_up = true;
+        else if (bottom_up && (frontier.size() < n / beta))
+            bottom_up = false;
+
+        if (!bottom_up) {
+            pool.parallel_for(0, frontier.size(), 64, [&] (std::size_t b, std::size_t e, unsigned id) {
+                for (std::size_t i = b; i != e; ++i) {
+                    const vertex_descriptor u = frontier[i];
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(u, g);
+                    for (; p.first != p.second; ++p.first) {
+                        const vertex_descriptor v = *p.first;
+                        int unseen = -1;
+                        if ((distance[v].load(std::memory_order_relaxed) == -1) &&
+                            distance[v].compare_exchange_strong(unseen, level + 1, std::memory_order_relaxed)) {
+                            parent[v] = u;
+                            local[id].push_back(v);
+                            local_edges[id] += degree[v];}}}});}
+        else {
+            ++r.bottom_up_levels;
+            if (in_offsets.empty()) {
+                in_offsets.assign(n + 1, 0);
+                for (std::size_t u = 0; u != n; ++u) {
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+                    for (; p.first != p.second; ++p.first)
+                        ++in_offsets[*p.first + 1];}
+                for (std::size_t v = 0; v != n; ++v)
+                    in_offsets[v + 1] += in_offsets[v];
+                in_sources.resize(m);
+                std::vector<std::size_t> fill(in_offsets.begin(), in_offsets.end() - 1);
+                for (std::size_t u = 0; u != n; ++u) {
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+                    for (; p.first != p.second; ++p.first)
+                        in_sources[fill[*p.first]++] = static_cast<vertex_descriptor>(u);}}
+
+            pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned id) {
+                for (std::size_t v = b; v != e; ++v) {
+                    if (distance[v].load(std::memory_order_relaxed) != -1)
+                        continue;
+                    for (std::size_t i = in_offsets[v]; i != in_offsets[v + 1]; ++i)
+                        if (distance[in_sources[i]].load(std::memory_order_relaxed) == level) {
+                            distance[v].store(level + 1, std::memory_order_relaxed);
+                            parent[v] = in_sources[i];
+                            local[id].push_back(static_cast<vertex_descriptor>(v));
+                            local_edges[id] += degree[v];
+                            break;}}});}
+
+        frontier.clear();
+        frontier_edges = 0;
+        for (std::size_t i = 0; i != local.size(); ++i) {
+            frontier.insert(frontier.end(), local[i].begin(), local[i].end());
+            frontier_edges += local_edges[i];
+            local[i].clear();
+            local_edges[i] = 0;}
+        unexplored_edges -= frontier_edges;}
+
+    r.distance.resize(n);
+    for (std::size_t u = 0; u != n; ++u)
+        r.distance[u] = distance[u].load(std::memory_order_relaxed);
+    r.parent.swap(parent);
+    return r;}
+
+/**
+ * @param g - constant reference to a directed graph
+ * @param s - source vertex
+ * @return breadth_first_search(g, s, default_pool())
+ */
+template <typename G>
+bfs_result<typename G::vertex_descriptor> breadth_first_search (const G& g, typename G::vertex_descriptor s) {
+    return breadth_first_search(g, s, default_pool());}
+
+// -----------------
+// algorithms_detail
+// -----------------
+
+namespace algorithms_detail {
+
+/**
+ * @param u   - vertex
+ * @param g   - constant reference to a directed graph
+ * @param buf - scratch space
+ * @return the out-neighbors of u as a strictly ascending int32_t array
+ * rows that already are one are returned in place, any other row is copied into buf and sorted
+ */
+template <typename G>
+std::pair<const std::int32_t*, std::size_t> sorted_row (typename G::vertex_descriptor u, const G& g, std::vector<std::int32_t>& buf, std::false_type) {
+    typedef typename G::adjacency_iterator adjacency_iterator;
+    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(u, g);
+    buf.clear();
+    for (; p.first != p.second; ++p.first)
+        buf.push_back(static_cast<std::int32_t>(*p.first));
+    std::sort(buf.begin(), buf.end());
+    buf.erase(std::unique(buf.begin(), buf.end()), buf.end());
+    return std::make_pair(buf.data(), buf.size());}
+
+template <typename G>
+std::pair<const std::int32_t*, std::size_t> sorted_row (typename G::vertex_descriptor u, const G& g, std::vector<std::int32_t>& buf, std::true_type) {
+    typedef typename G::adjacency_iterator adjacency_iterator;
+    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(u, g);
+    if (!std::is_sorted(p.first, p.second))
+        return sorted_row(u, g, buf, std::false_type());
+    return std::make_pair(p.first, static_cast<std::size_t>(p.second - p.first));}
+
+template <typename G>
+std::pair<const std::int32_t*, std::size_t> sorted_row (typename G::vertex_descriptor u, const G& g, std::vector<std::int32_t>& buf) {
+    return sorted_row(u, g, buf, std::integral_constant<bool, std::is_same<typename G::adjacency_iterator, const std::int32_t*>::value>());}
+
+/**
+ * rows of a graph in CSR form, every row strictly ascending
+ */
+struct sorted_rows {
+    std::vector<std::size_t>  offsets;
+    std::vector<std::int32_t> targets;
+
+    std::size_t degree (std::size_t u) const {
+        return offsets[u + 1] - offsets[u];}
+
+    const std::int32_t* row (std::size_t u) const {
+        return targets.data() + offsets[u];}};
+
+/**
+ * @param g    - constant reference to a directed graph
+ * @param pool - threads to run on
+ * @return the simple undirected graph under g: every edge in both directions, no self-loops, no repeats
+ */
+template <typename G>
+sorted_rows undirected_rows (const G& g, ThreadPool& pool) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t n     = num_vertices(g);
+    const std::size_t grain = 1024;
+    assert(n <= static_cast<std::size_t>(INT32_MAX));
+    std::unique_ptr<std::atomic<std::size_t>[]> fill(new std::atomic<std::size_t>[n + 1]);
+
+    pool.parallel_for(0, n + 1, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u)
+            fill[u].store(0, std::memory_order_relaxed);});
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u) {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+            for (; p.first != p.second; ++p.first)
+                if (static_cast<std::size_t>(*p.first) != u) {
+                    fill[u].fetch_add(1, std::memory_order_relaxed);
+                    fill[*p.first].fetch_add(1, std::memory_order_relaxed);}}});
+
+    std::vector<std::size_t> offsets(n + 1, 0);
+    for (std::size_t u = 0; u != n; ++u) {
+        offsets[u + 1] = offsets[u] + fill[u].load(std::memory_order_relaxed);
+        fill[u].store(offsets[u], std::memory_order_relaxed);}
+    std::vector<std::int32_t> targets(offsets[n]);
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u) {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+            for (; p.first != p.second; ++p.first) {
+                const std::size_t v = static_cast<std::size_t>(*p.first);
+                if (v != u) {
+                    targets[fill[u].fetch_add(1, std::memory_order_relaxed)] = static_cast<std::int32_t>(v);
+                    targets[fill[v].fetch_add(1, std::memory_order_relaxed)] = static_cast<std::int32_t>(u);}}}});
+
+    // reciprocal edges leave repeats, which are dropped while the rows are compacted
+    std::vector<std::size_t> degree(n);
+    pool.parallel_for(0, n, 64, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u) {
+            std::int32_t* const first = targets.data() + offsets[u];
+            std::int32_t* const last  = targets.data() + offsets[u + 1];
+            std::sort(first, last);
+            degree[u] = static_cast<std::size_t>(std::unique(first, last) - first);}});
+
+    sorted_rows r;
+    r.offsets.assign(n + 1, 0);
+    for (std::size_t u = 0; u != n; ++u)
+        r.offsets[u + 1] = r.offsets[u] + degree[u];
+    r.targets.resize(r.offsets[n]);
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u)
+            std::copy(targets.begin() + offsets[u], targets.begin() + offsets[u] + degree[u], r.targets.begin() + r.offsets[u]);});
+    return r;}
+
+/**
+ * @param r    - rows of a simple undirected graph
+ * @param pool - threads to run on
+ * @return r with each edge kept only at its endpoint of lower (degree, id), so every triangle
+ *         is seen once and no row is longer than about sqrt(2m)
+ */
+inline sorted_rows oriented_rows (const sorted_rows& r, ThreadPool& pool) {
+    const std::size_t n     = r.offsets.size() - 1;
+    const std::size_t grain = 1024;
+    std::vector<std::size_t> degree(n);
+    auto lower = [&] (std::size_t u, std::size_t v) {
+        return (r.degree(u) < r.degree(v)) || ((r.degree(u) == r.degree(v)) && (u < v));};
+
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u) {
+            degree[u] = 0;
+            for (const std::int32_t* i = r.row(u); i != r.row(u) + r.degree(u); ++i)
+                degree[u] += lower(u, static_cast<std::size_t>(*i));}});
+
+    sorted_rows o;
+    o.offsets.assign(n + 1, 0);
+    for (std::size_t u = 0; u != n; ++u)
+        o.offsets[u + 1] = o.offsets[u] + degree[u];
+    o.targets.resize(o.offsets[n]);
+    pool.parallel_for(0, n, grain, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t u = b; u != e; ++u) {
+            std::size_t k = o.offsets[u];
+            for (const std::int32_t* i = r.row(u); i != r.row(u) + r.degree(u); ++i)
+                if (lower(u, static_cast<std::size_t>(*i)))
+                    o.targets[k++] = *i;}});
+    return o;}
+
+} // algorithms_detail
+
+// ----------------
+// common_neighbors
+// ----------------
+
+/**
+ * @param u - vertex
+ * @param v - vertex
+ * @param g - constant reference to a directed graph
+ * @return the vertices both u and v have an edge to, ascending
+ * sorted int32_t rows (CsrGraph, small_vectorS rows) are intersected in place, others are sorted first
+ */
+template <typename G>
+std::vector<typename G::vertex_descriptor> common_neighbors (typename G::vertex_descriptor u, typename G::vertex_descriptor v, const G& g) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    std::vector<std::int32_t> a;
+    std::vector<std::int32_t> b;
+    const std::pair<const std::int32_t*, std::size_t> p = algorithms_detail::sorted_row(u, g, a);
+    const std::pair<const std::int32_t*, std::size_t> q = algorithms_detail::sorted_row(v, g, b);
+
+    std::vector<std::int32_t> c(std::min(p.second, q.second));
+    c.resize(intersect(p.first, p.second, q.first, q.second, c.data()));
+    return std::vector<vertex_descriptor>(c.begin(), c.end());}
+
+// ---------------
+// count_triangles
+// ---------------
+
+/**
+ * @param g    - constant reference to a directed graph
+ * @param pool - threads to run on
+ * @return number of triangles in the simple undirected graph under g
+ * each edge is oriented from its endpoint of lower degree, then every oriented
+ * edge u -> v adds |out(u) & out(v)|; vertices are split across the pool
+ */
+template <typename G>
+std::uint64_t count_triangles (const G& g, ThreadPool& pool) {
+    const algorithms_detail::sorted_rows o = algorithms_detail::oriented_rows(algorithms_detail::undirected_rows(g, pool), pool);
+    const std::size_t          n = o.offsets.size() - 1;
+    std::vector<std::uint64_t> local(pool.size(), 0);
+
+    pool.parallel_for(0, n, 64, [&] (std::size_t b, std::size_t e, unsigned id) {
+        std::uint64_t t = 0;
+        for (std::size_t u = b; u != e; ++u)
+            for (const std::int32_t* i = o.row(u); i != o.row(u) + o.degree(u); ++i)
+                t += intersect(o.row(u), o.degree(u), o.row(*i), o.degree(*i));
+        local[id] += t;});
+
+    std::uint64_t t = 0;
+    for (std::size_t i = 0; i != local.size(); ++i)
+        t += local[i];
+    return t;}
+
+/**
+ * @param g - constant reference to a directed graph
+ * @return count_triangles(g, default_pool())
+ */
+template <typename G>
+std::uint64_t count_triangles (const G& g) {
+    return count_triangles(g, default_pool());}
+
+// ----------------
+// local_clustering
+// ----------------
+
+/**
+ * @param g    - constant reference to a directed graph
+ * @param pool - threads to run on
+ * @return for each vertex v of the simple undirected graph under g, the fraction of pairs
+ *         of v's neighbors that are adjacent, 0 when v has fewer than two neighbors
+ */
+template <typename G>
+std::vector<double> local_clustering (const G& g, ThreadPool& pool) {
+    const algorithms_detail::sorted_rows r = algorithms_detail::undirected_rows(g, pool);
+    const std::size_t   n = r.offsets.size() - 1;
+    std::vector<double> c(n, 0.0);
+
+    pool.parallel_for(0, n, 64, [&] (std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t v = b; v != e; ++v) {
+            const std::size_t d = r.degree(v);
+            if (d < 2)
+                continue;
+            std::uint64_t t = 0; // twice the triangles through v
+            for (const std::int32_t* i = r.row(v); i != r.row(v) + d; ++i)
+                t += intersect(r.row(v), d, r.row(*i), r.degree(*i));
+            c[v] = static_cast<double>(t) / (static_cast<double>(d) * (d - 1));}});
+    return c;}
+
+/**
+ * @param g - constant reference to a directed graph
+ * @return local_clustering(g, default_pool())
+ */
+template <typename G>
+std::vector<double> local_clustering (const G& g) {
+    return local_clustering(g, default_pool());}
+
+#endif // GraphAlgorithms_h
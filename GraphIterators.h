@@ -0,0 +1,338 @@
+// -------------------------------
+// projects/graph/GraphIterators.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef GraphIterators_h
+#define GraphIterators_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>  // ptrdiff_t
+#include <iterator> // random_access_iterator_tag, forward_iterator_tag
+#include <utility>  // make_pair, pair
+
+// -----------------
+// counting_iterator
+// -----------------
+
+/**
+ * random access iterator over the values [b, e) of an integral type
+ * used by graphs whose vertex set is always 0..n-1, so no vertex list has to be stored
+ */
+template <typename T>
+class counting_iterator {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T                               value_type;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef const T*                        pointer;
+        typedef T                               reference;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        T _v;
+
+    public:
+        // -----------
+        // constructor
+        // -----------
+
+        explicit counting_iterator (T v = T()) :
+                _v (v)
+            {}
+
+        // ----------
+        // operator *
+        // ----------
+
+        reference operator * () const {
+            return _v;}
+
+        // -----------
+        // operator []
+        // -----------
+
+        reference operator [] (difference_type n) const {
+            return static_cast<T>(_v + n);}
+
+        // -----------
+        // operator ++
+        // -----------
+
+        counting_iterator& operator ++ () {
+            ++_v;
+            return *this;}
+
+        counting_iterator operator ++ (int) {
+            counting_iterator x = *this;
+            ++*this;
+            return x;}
+
+        // -----------
+        // operator --
+        // -----------
+
+        counting_iterator& operator -- () {
+            --_v;
+            return *this;}
+
+        counting_iterator operator -- (int) {
+            counting_iterator x = *this;
+            --*this;
+            return x;}
+
+        // ---------------
+        // operator +=, -=
+        // ---------------
+
+        counting_iterator& operator += (difference_type n) {
+            _v = static_cast<T>(_v + n);
+            return *this;}
+
+        counting_iterator& operator -= (difference_type n) {
+            _v = static_cast<T>(_v - n);
+            return *this;}
+
+        // -------------
+        // operator +, -
+        // -------------
+
+        friend counting_iterator operator + (counting_iterator lhs, difference_type n) {
+            return lhs += n;}
+
+        friend counting_iterator operator + (difference_type n, counting_iterator rhs) {
+            return rhs += n;}
+
+        friend counting_iterator operator - (counting_iterator lhs, difference_type n) {
+            return lhs -= n;}
+
+        friend difference_type operator - (const counting_iterator& lhs, const counting_iterator& rhs) {
+            return static_cast<difference_type>(lhs._v) - static_cast<difference_type>(rhs._v);}
+
+        // -----------
+        // comparisons
+        // -----------
+
+        friend bool operator == (const counting_iterator& lhs, const counting_iterator& rhs) {
+            return lhs._v == rhs._v;}
+
+        friend bool operator != (const counting_iterator& lhs, const counting_iterator& rhs) {
+            return !(lhs == rhs);}
+
+        friend bool operator < (const counting_iterator& lhs, const counting_iterator& rhs) {
+            return lhs._v < rhs._v;}
+
+        friend bool operator > (const counting_iterator& lhs, const counting_iterator& rhs) {
+            return rhs < lhs;}
+
+        friend bool operator <= (const counting_iterator& lhs, const counting_iterator& rhs) {
+            return !(rhs < lhs);}
+
+        friend bool operator >= (const counting_iterator& lhs, const counting_iterator& rhs) {
+            return !(lhs < rhs);}};
+
+// -----------------
+// csr_edge_iterator
+// -----------------
+
+/**
+ * forward iterator over the edges of a compressed sparse row graph
+ * yields (source, target) pairs in source-major order
+ * the source is recovered by walking the offsets array alongside the target index
+ */
+template <typename V, typename O>
+class csr_edge_iterator {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<V, V>           value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef const value_type*         pointer;
+        typedef value_type                reference;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        const O* _offsets;
+        const V* _targets;
+        O        _n;        // number of vertices
+        O        _u;        // current source
+        O        _i;        // current index into _targets
+
+        // ----
+        // skip
+        // ----
+
+        /**
+         * moves _u forward past every row that ends at or before _i
+         */
+        void skip () {
+            while ((_u < _n) && (_offsets[_u + 1] <= _i))
+                ++_u;}
+
+    public:
+        // -----------
+        // constructor
+        // -----------
+
+        /**
+         * @param offsets - row offsets, n + 1 entries
+         * @param targets - concatenated sorted rows
+         * @param n       - number of vertices
+         * @param i       - index of the edge to start at, offsets[n] for the end
+         */
+        csr_edge_iterator (const O* offsets = 0, const V* targets = 0, O n = 0, O i = 0) :
+                _offsets (offsets),
+                _targets (targets),
+                _n       (n),
+                _u       (0),
+                _i       (i) {
+            if (_offsets == 0)
+                return;
+            if (_i == _offsets[_n])
+                _u = _n;
+            else
+                skip();}
+
+        // ----------
+        // operator *
+        // ----------
+
+        reference operator * () const {
+            return std::make_pair(static_cast<V>(_u), _targets[_i]);}
+
+        // -----------
+        // operator ++
+        // -----------
+
+        csr_edge_iterator& operator ++ () {
+            ++_i;
+            skip();
+            return *this;}
+
+        csr_edge_iterator operator ++ (int) {
+            csr_edge_iterator x = *this;
+            ++*this;
+            return x;}
+
+        // -----------
+        // comparisons
+        // -----------
+
+        friend bool operator == (const csr_edge_iterator& lhs, const csr_edge_iterator& rhs) {
+            return lhs._i == rhs._i;}
+
+        friend bool operator != (const csr_edge_iterator& lhs, const csr_edge_iterator& rhs) {
+            return !(lhs == rhs);}};
+
+// -----------------
+// row_edge_iterator
+// -----------------
+
+/**
+ * forward iterator over the edges of a graph stored as one out-edge row per vertex
+ * yields (source, target) pairs in source-major, row order without storing an edge list
+ */
+template <typename Row, typename V>
+class row_edge_iterator {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<V, V>           value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef const value_type*         pointer;
+        typedef value_type                reference;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        const Row*                    _rows;
+        std::size_t                   _n;    // number of rows
+        std::size_t                   _u;    // current source, _n at the end
+        typename Row::const_iterator  _i;    // current target within _rows[_u]
+
+        // ----
+        // skip
+        // ----
+
+        /**
+         * moves to the first target of the next non-empty row when _i is at the end of its row
+         */
+        void skip () {
+            while ((_u < _n) && (_i == _rows[_u].end())) {
+                ++_u;
+                if (_u < _n)
+                    _i = _rows[_u].begin();}}
+
+    public:
+        // -----------
+        // constructor
+        // -----------
+
+        /**
+         * @param rows - array of n rows
+         * @param n    - number of rows
+         * @param u    - row to start at, n for the end
+         */
+        row_edge_iterator (const Row* rows = 0, std::size_t n = 0, std::size_t u = 0) :
+                _rows (rows),
+                _n    (n),
+                _u    (u),
+                _i    () {
+            if (_u < _n) {
+                _i = _rows[_u].begin();
+                skip();}}
+
+        // ----------
+        // operator *
+        // ----------
+
+        reference operator * () const {
+            return std::make_pair(static_cast<V>(_u), static_cast<V>(*_i));}
+
+        // -----------
+        // operator ++
+        // -----------
+
+        row_edge_iterator& operator ++ () {
+            ++_i;
+            skip();
+            return *this;}
+
+        row_edge_iterator operator ++ (int) {
+            row_edge_iterator x = *this;
+            ++*this;
+            return x;}
+
+        // -----------
+        // comparisons
+        // -----------
+
+        friend bool operator == (const row_edge_iterator& lhs, const row_edge_iterator& rhs) {
+            return (lhs._u == rhs._u) && ((lhs._u >= lhs._n) || (lhs._i == rhs._i));}
+
+        friend bool operator != (const row_edge_iterator& lhs, const row_edge_iterator& rhs) {
+            return !(lhs == rhs);}};
+
+#endif // GraphIterators_h
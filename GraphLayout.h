@@ -0,0 +1,197 @@
+// ----------------------------
+// projects/graph/GraphLayout.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef GraphLayout_h
+#define GraphLayout_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+#include <cstdint> // int32_t
+#include <utility> // make_pair, pair
+#include <vector>  // vector
+
+#include "GraphIterators.h"
+
+// ---------
+// selectors
+// ---------
+
+// Layout selectors decide what a BasicGraph keeps besides its out-edge rows.
+
+/**
+ * stores the vertex list and an edge list next to the rows;
+ * vertices are int and edges() walks the edges in insertion order
+ */
+struct indexedS {
+    typedef int vertex_descriptor;};
+
+/**
+ * stores nothing but the rows; vertices() and edges() are computed from them,
+ * vertices are Id and edges() walks the edges in source-major, row order
+ */
+template <typename Id = std::int32_t>
+struct compactS {
+    typedef Id vertex_descriptor;};
+
+// ------------
+// graph_memory
+// ------------
+
+/**
+ * bytes held by a graph, by component
+ */
+struct graph_memory {
+    std::size_t object;    // sizeof the graph itself
+    std::size_t rows;      // the array of per-vertex rows, or the CSR offsets
+    std::size_t adjacency; // targets owned by the rows, or the CSR targets
+    std::size_t vertices;  // a stored vertex list
+    std::size_t edges;     // a stored edge list
+
+    graph_memory () :
+            object    (0),
+            rows      (0),
+            adjacency (0),
+            vertices  (0),
+            edges     (0)
+        {}
+
+    std::size_t total () const {
+        return object + rows + adjacency + vertices + edges;}};
+
+// ------------
+// graph_layout
+// ------------
+
+/**
+ * the part of a BasicGraph chosen by its layout selector
+ * BasicGraph tells it about every vertex and edge it adds and asks it for vertices() and edges()
+ */
+template <typename LayoutS, typename Row>
+class graph_layout;
+
+template <typename Row>
+class graph_layout<indexedS, Row> {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef indexedS::vertex_descriptor                     vertex_descriptor;
+        typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
+
+        typedef typename std::vector<vertex_descriptor>::const_iterator vertex_iterator;
+        typedef typename std::vector<edge_descriptor>::const_iterator   edge_iterator;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        std::vector<vertex_descriptor> _vertices;
+        std::vector<edge_descriptor>   _edges;
+
+    public:
+        void grow (std::size_t s, std::size_t n) {
+            _vertices.reserve(n);
+            for (std::size_t i = s; i != n; ++i)
+                _vertices.push_back(static_cast<vertex_descriptor>(i));}
+
+        void reserve_edges (std::size_t k) {
+            _edges.reserve(_edges.size() + k);}
+
+        void added (const edge_descriptor& e) {
+            _edges.push_back(e);}
+
+        /**
+         * @param rows - rows of a graph built without this layout
+         * recreates the vertex and edge lists, listing the edges in row order
+         */
+        void rebuild (const std::vector<Row>& rows) {
+            _vertices.clear();
+            _edges.clear();
+            grow(0, rows.size());
+            for (std::size_t u = 0; u != rows.size(); ++u)
+                for (typename Row::const_iterator i = rows[u].begin(); i != rows[u].end(); ++i)
+                    _edges.push_back(std::make_pair(static_cast<vertex_descriptor>(u), *i));}
+
+        std::size_t num_edges (const std::vector<Row>&) const {
+            return _edges.size();}
+
+        vertex_descriptor vertex (std::size_t i) const {
+            return _vertices[i];}
+
+        std::pair<vertex_iterator, vertex_iterator> vertices (const std::vector<Row>&) const {
+            return std::make_pair(_vertices.begin(), _vertices.end());}
+
+        std::pair<edge_iterator, edge_iterator> edges (const std::vector<Row>&) const {
+            return std::make_pair(_edges.begin(), _edges.end());}
+
+        bool valid (const std::vector<Row>& rows) const {
+            return _vertices.size() == rows.size();}
+
+        void memory (graph_memory& m) const {
+            m.vertices = _vertices.capacity() * sizeof(vertex_descriptor);
+            m.edges    = _edges.capacity()    * sizeof(edge_descriptor);}};
+
+template <typename Id, typename Row>
+class graph_layout<compactS<Id>, Row> {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef Id                                              vertex_descriptor;
+        typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
+
+        typedef counting_iterator<vertex_descriptor>      vertex_iterator;
+        typedef row_edge_iterator<Row, vertex_descriptor> edge_iterator;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        std::size_t _num_edges;
+
+    public:
+        graph_layout () :
+                _num_edges (0)
+            {}
+
+        void grow (std::size_t, std::size_t) {}
+
+        void reserve_edges (std::size_t) {}
+
+        void added (const edge_descriptor&) {
+            ++_num_edges;}
+
+        void rebuild (const std::vector<Row>& rows) {
+            _num_edges = 0;
+            for (std::size_t u = 0; u != rows.size(); ++u)
+                _num_edges += rows[u].size();}
+
+        std::size_t num_edges (const std::vector<Row>&) const {
+            return _num_edges;}
+
+        vertex_descriptor vertex (std::size_t i) const {
+            return static_cast<vertex_descriptor>(i);}
+
+        std::pair<vertex_iterator, vertex_iterator> vertices (const std::vector<Row>& rows) const {
+            return std::make_pair(vertex_iterator(0), vertex_iterator(static_cast<vertex_descriptor>(rows.size())));}
+
+        std::pair<edge_iterator, edge_iterator> edges (const std::vector<Row>& rows) const {
+            const Row* r = rows.empty() ? 0 : &rows[0];
+            return std::make_pair(edge_iterator(r, rows.size(), 0), edge_iterator(r, rows.size(), rows.size()));}
+
+        bool valid (const std::vector<Row>&) const {
+            return true;}
+
+        void memory (graph_memory&) const {}};
+
+#endif // GraphLayout_h
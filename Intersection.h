@@ -0,0 +1,212 @@
+// -----------------------------
+// projects/graph/Intersection.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef Intersection_h
+#define Intersection_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+#include <cstdint> // int32_t
+#include <utility> // swap
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define GRAPH_X86_KERNELS 1
+#include <immintrin.h> // _mm_*, _mm256_*
+#endif
+
+// Every kernel below intersects two strictly ascending arrays of int32_t.
+// It returns the size of the intersection, and it also writes the
+// intersection in ascending order to out unless out is null. out needs room
+// for min(na, nb) elements.
+
+// ----------------
+// intersect_scalar
+// ----------------
+
+/**
+ * branchy merge, one comparison per step
+ */
+inline std::size_t intersect_scalar (const std::int32_t* a, std::size_t na, const std::int32_t* b, std::size_t nb, std::int32_t* out) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t n = 0;
+    while ((i != na) && (j != nb)) {
+        if (a[i] < b[j])
+            ++i;
+        else if (b[j] < a[i])
+            ++j;
+        else {
+            if (out)
+                out[n] = a[i];
+            ++n;
+            ++i;
+            ++j;}}
+    return n;}
+
+// -------------------
+// intersect_galloping
+// -------------------
+
+/**
+ * for each element of a, doubles a step through b until it passes the element,
+ * then binary searches the last step; O(na log(nb / na)), the choice when nb >> na
+ */
+inline std::size_t intersect_galloping (const std::int32_t* a, std::size_t na, const std::int32_t* b, std::size_t nb, std::int32_t* out) {
+    std::size_t j = 0;
+    std::size_t n = 0;
+    for (std::size_t i = 0; (i != na) && (j != nb); ++i) {
+        const std::int32_t x = a[i];
+        std::size_t step = 1;
+        std::size_t hi   = j;
+        while ((hi < nb) && (b[hi] < x)) {
+            j     = hi + 1;
+            hi   += step;
+            step *= 2;}
+        if (hi > nb)
+            hi = nb;
+        while (j < hi) {
+            const std::size_t mid = j + (hi - j) / 2;
+            if (b[mid] < x)
+                j = mid + 1;
+            else
+                hi = mid;}
+        if ((j != nb) && (b[j] == x)) {
+            if (out)
+                out[n] = x;
+            ++n;
+            ++j;}}
+    return n;}
+
+#ifdef GRAPH_X86_KERNELS
+
+// -------------
+// intersect_sse
+// -------------
+
+/**
+ * compares a block of 4 elements of a with every rotation of a block of 4 elements of b,
+ * then advances whichever block ends lower (both on a tie); the tails are merged by intersect_scalar
+ */
+inline std::size_t intersect_sse (const std::int32_t* a, std::size_t na, const std::int32_t* b, std::size_t nb, std::int32_t* out) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t n = 0;
+    while ((i + 4 <= na) && (j + 4 <= nb)) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i m =                  _mm_cmpeq_epi32(va, vb);
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m)));
+        if (out)
+            for (; mask != 0; mask &= mask - 1)
+                out[n++] = a[i + __builtin_ctz(mask)];
+        else
+            n += __builtin_popcount(mask);
+        const std::int32_t amax = a[i + 3];
+        const std::int32_t bmax = b[j + 3];
+        if (amax <= bmax)
+            i += 4;
+        if (bmax <= amax)
+            j += 4;}
+    return n + intersect_scalar(a + i, na - i, b + j, nb - j, out ? out + n : 0);}
+
+// --------------
+// intersect_avx2
+// --------------
+
+/**
+ * intersect_sse with blocks of 8; only call it when cpu_supports_avx2()
+ */
+__attribute__((target("avx2")))
+inline std::size_t intersect_avx2 (const std::int32_t* a, std::size_t na, const std::int32_t* b, std::size_t nb, std::int32_t* out) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t n = 0;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while ((i + 8 <= na) && (j + 8 <= nb)) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i       vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i       m  = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r != 8; ++r) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            m  = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));}
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+        if (out)
+            for (; mask != 0; mask &= mask - 1)
+                out[n++] = a[i + __builtin_ctz(mask)];
+        else
+            n += __builtin_popcount(mask);
+        const std::int32_t amax = a[i + 7];
+        const std::int32_t bmax = b[j + 7];
+        if (amax <= bmax)
+            i += 8;
+        if (bmax <= amax)
+            j += 8;}
+    return n + intersect_sse(a + i, na - i, b + j, nb - j, out ? out + n : 0);}
+
+#endif // GRAPH_X86_KERNELS
+
+// -----------------
+// cpu_supports_avx2
+// -----------------
+
+/**
+ * @return whether intersect_avx2 exists and this CPU can run it
+ */
+inline bool cpu_supports_avx2 () {
+#ifdef GRAPH_X86_KERNELS
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");}
+#else
+    return false;}
+#endif
+
+// ----------------
+// intersect_kernel
+// ----------------
+
+typedef std::size_t (*intersect_function) (const std::int32_t*, std::size_t, const std::int32_t*, std::size_t, std::int32_t*);
+
+/**
+ * @return the widest block kernel this CPU runs, chosen on the first call
+ */
+inline intersect_function intersect_kernel () {
+#ifdef GRAPH_X86_KERNELS
+    static const intersect_function f = cpu_supports_avx2() ? &intersect_avx2 : &intersect_sse;
+#else
+    static const intersect_function f = &intersect_scalar;
+#endif
+    return f;}
+
+// ---------
+// intersect
+// ---------
+
+/**
+ * @param a   - strictly ascending array
+ * @param na  - length of a
+ * @param b   - strictly ascending array
+ * @param nb  - length of b
+ * @param out - null, or room for min(na, nb) elements that receive the intersection in ascending order
+ * @return size of the intersection of a and b
+ * gallops through the longer array when one array is at least 32 times the other, otherwise runs intersect_kernel()
+ */
+inline std::size_t intersect (const std::int32_t* a, std::size_t na, const std::int32_t* b, std::size_t nb, std::int32_t* out = 0) {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);}
+    if (na == 0)
+        return 0;
+    if (nb / na >= 32)
+        return intersect_galloping(a, na, b, nb, out);
+    return intersect_kernel()(a, na, b, nb, out);}
+
+#endif // Intersection_h
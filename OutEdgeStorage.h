@@ -0,0 +1,555 @@
+// -------------------------------
+// projects/graph/OutEdgeStorage.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef OutEdgeStorage_h
+#define OutEdgeStorage_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm>   // lower_bound
+#include <cassert>     // assert
+#include <cstddef>     // size_t
+#include <cstring>     // memcpy, memmove
+#include <limits>      // numeric_limits
+#include <memory>      // unique_ptr
+#include <set>         // set
+#include <type_traits> // is_trivially_copyable
+#include <utility>     // move
+#include <vector>      // vector
+
+// ---------
+// selectors
+// ---------
+
+// Selectors name the container a BasicGraph keeps each vertex's out-edges in,
+// in the manner of boost::setS and boost::vecS.
+
+/**
+ * std::set per vertex; sorted iteration, O(log d) insert and lookup
+ */
+struct ordered_setS {};
+
+/**
+ * sorted array per vertex, the first N targets stored inline; sorted iteration,
+ * O(log d) lookup, O(d) insert, no allocation below N out-edges
+ */
+template <std::size_t N = 8>
+struct small_vectorS {};
+
+/**
+ * array plus open-addressing hash index per vertex; insertion-order iteration,
+ * O(1) insert and lookup
+ */
+struct hash_setS {};
+
+/**
+ * starts as small_vectorS<N> and adds a hash index once a vertex has more than Threshold out-edges;
+ * rows stay sorted until then and later targets are appended in insertion order
+ */
+template <std::size_t N = 8, std::size_t Threshold = 64>
+struct adaptiveS {};
+
+// ------------
+// small_vector
+// ------------
+
+/**
+ * contiguous array of trivially copyable T whose first N elements live inside the object
+ */
+template <typename T, std::size_t N>
+class small_vector {
+    static_assert(N > 0, "small_vector needs inline room");
+    static_assert(std::is_trivially_copyable<T>::value, "small_vector moves elements with memcpy");
+
+    private:
+        // ----
+        // data
+        // ----
+
+        T*          _data;
+        std::size_t _size;
+        std::size_t _capacity;
+        T           _inline[N];
+
+        /**
+         * @return whether the elements have spilled to the heap
+         */
+        bool spilled () const {
+            return _data != _inline;}
+
+        /**
+         * @param c - new capacity, at least size()
+         */
+        void reallocate (std::size_t c) {
+            T* p = new T[c];
+            std::memcpy(p, _data, _size * sizeof(T));
+            if (spilled())
+                delete [] _data;
+            _data     = p;
+            _capacity = c;}
+
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef const T* const_iterator;
+
+        // ------------
+        // constructors
+        // ------------
+
+        small_vector () :
+                _data     (_inline),
+                _size     (0),
+                _capacity (N)
+            {}
+
+        small_vector (const small_vector& that) :
+                _data     (_inline),
+                _size     (0),
+                _capacity (N) {
+            if (that._size > N)
+                reallocate(that._size);
+            std::memcpy(_data, that._data, that._size * sizeof(T));
+            _size = that._size;}
+
+        small_vector (small_vector&& that) noexcept :
+                _data     (_inline),
+                _size     (that._size),
+                _capacity (N) {
+            if (that.spilled()) {
+                _data          = that._data;
+                _capacity      = that._capacity;
+                that._data     = that._inline;
+                that._capacity = N;}
+            else
+                std::memcpy(_inline, that._inline, _size * sizeof(T));
+            that._size = 0;}
+
+        small_vector& operator = (const small_vector& that) {
+            if (this != &that) {
+                _size = 0;
+                if (that._size > _capacity)
+                    reallocate(that._size);
+                std::memcpy(_data, that._data, that._size * sizeof(T));
+                _size = that._size;}
+            return *this;}
+
+        small_vector& operator = (small_vector&& that) noexcept {
+            if (this != &that) {
+                if (spilled())
+                    delete [] _data;
+                _data     = _inline;
+                _capacity = N;
+                _size     = that._size;
+                if (that.spilled()) {
+                    _data          = that._data;
+                    _capacity      = that._capacity;
+                    that._data     = that._inline;
+                    that._capacity = N;}
+                else
+                    std::memcpy(_inline, that._inline, _size * sizeof(T));
+                that._size = 0;}
+            return *this;}
+
+        ~small_vector () {
+            if (spilled())
+                delete [] _data;}
+
+        // ----
+        // swap
+        // ----
+
+        void swap (small_vector& that) noexcept {
+            small_vector tmp(std::move(that));
+            that  = std::move(*this);
+            *this = std::move(tmp);}
+
+        // ---------
+        // accessors
+        // ---------
+
+        const_iterator begin    () const {return _data;}
+        const_iterator end      () const {return _data + _size;}
+        std::size_t    size     () const {return _size;}
+        std::size_t    capacity () const {return _capacity;}
+        bool           empty    () const {return _size == 0;}
+        const T&       back     () const {return _data[_size - 1];}
+
+        /**
+         * @return bytes allocated outside the object, 0 while the elements fit inline
+         */
+        std::size_t heap_bytes () const {
+            return spilled() ? _capacity * sizeof(T) : 0;}
+
+        // ---------
+        // push_back
+        // ---------
+
+        void push_back (const T& v) {
+            if (_size == _capacity)
+                reallocate(2 * _capacity);
+            _data[_size++] = v;}
+
+        // ------
+        // insert
+        // ------
+
+        /**
+         * @param i - position in [begin(), end()]
+         * @param v - value to place at i
+         */
+        void insert (const_iterator i, const T& v) {
+            const std::size_t k = i - _data;
+            if (_size == _capacity)
+                reallocate(2 * _capacity);
+            std::memmove(_data + k + 1, _data + k, (_size - k) * sizeof(T));
+            _data[k] = v;
+            ++_size;}};
+
+// ---------------
+// open_hash_index
+// ---------------
+
+/**
+ * set of non-negative integers with linear probing in a power of two table kept at most half full
+ */
+template <typename V>
+class open_hash_index {
+    private:
+        // ----
+        // data
+        // ----
+
+        std::vector<V> _slots;
+        std::size_t    _size;
+
+        static V empty_slot () {
+            return std::numeric_limits<V>::is_signed ? static_cast<V>(-1) : std::numeric_limits<V>::max();}
+
+    public:
+        /**
+         * @return largest value the index can hold; an unsigned V gives up its maximum to mark empty slots
+         */
+        static V max_value () {
+            return std::numeric_limits<V>::is_signed ? std::numeric_limits<V>::max() : static_cast<V>(std::numeric_limits<V>::max() - 1);}
+
+    private:
+
+        /**
+         * @return first slot to probe for v, from Fibonacci hashing
+         */
+        std::size_t home (V v) const {
+            return static_cast<std::size_t>((static_cast<unsigned long long>(v) * 11400714819323198485ULL) >> 32) & (_slots.size() - 1);}
+
+        void rehash (std::size_t c) {
+            std::vector<V> old(c, empty_slot());
+            old.swap(_slots);
+            for (std::size_t i = 0; i != old.size(); ++i)
+                if (old[i] != empty_slot()) {
+                    std::size_t j = home(old[i]);
+                    while (_slots[j] != empty_slot())
+                        j = (j + 1) & (_slots.size() - 1);
+                    _slots[j] = old[i];}}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param n - number of elements to make room for
+         */
+        explicit open_hash_index (std::size_t n = 0) :
+                _slots (16, empty_slot()),
+                _size  (0) {
+            std::size_t c = 16;
+            while (c < 2 * n)
+                c *= 2;
+            if (c != _slots.size())
+                _slots.assign(c, empty_slot());}
+
+        // ------
+        // insert
+        // ------
+
+        /**
+         * @return whether v was not yet present
+         */
+        bool insert (V v) {
+            assert(v != empty_slot());
+            if (2 * (_size + 1) > _slots.size())
+                rehash(2 * _slots.size());
+            std::size_t j = home(v);
+            while (_slots[j] != empty_slot()) {
+                if (_slots[j] == v)
+                    return false;
+                j = (j + 1) & (_slots.size() - 1);}
+            _slots[j] = v;
+            ++_size;
+            return true;}
+
+        // --------
+        // contains
+        // --------
+
+        bool contains (V v) const {
+            std::size_t j = home(v);
+            while (_slots[j] != empty_slot()) {
+                if (_slots[j] == v)
+                    return true;
+                j = (j + 1) & (_slots.size() - 1);}
+            return false;}
+
+        // ---------
+        // accessors
+        // ---------
+
+        std::size_t size  () const {return _size;}
+        std::size_t slots () const {return _slots.size();}
+
+        /**
+         * @return bytes allocated outside the object
+         */
+        std::size_t heap_bytes () const {
+            return _slots.capacity() * sizeof(V);}};
+
+// -------
+// set_row
+// -------
+
+/**
+ * out-edges of one vertex under ordered_setS
+ */
+template <typename V>
+class set_row {
+    private:
+        std::set<V> _s;
+
+    public:
+        typedef typename std::set<V>::const_iterator const_iterator;
+
+        /**
+         * @return largest target the row can hold
+         */
+        static V max_target () {
+            return std::numeric_limits<V>::max();}
+
+        /**
+         * @return whether v was not yet present
+         */
+        bool insert (V v) {
+            return _s.insert(v).second;}
+
+        /**
+         * insert for callers that add targets in ascending order; O(1) when v is the largest
+         */
+        bool append (V v) {
+            const std::size_t s = _s.size();
+            _s.insert(_s.end(), v);
+            return _s.size() != s;}
+
+        bool           contains (V v) const {return _s.find(v) != _s.end();}
+        const_iterator begin    ()    const {return _s.begin();}
+        const_iterator end      ()    const {return _s.end();}
+        std::size_t    size     ()    const {return _s.size();}
+
+        /**
+         * @return estimated heap bytes: one red-black node per target, a color word and
+         * three pointers plus the value, rounded up to the allocator's 16-byte granule
+         */
+        std::size_t heap_bytes () const {
+            const std::size_t node = (4 * sizeof(void*) + sizeof(V) + 15) / 16 * 16;
+            return _s.size() * node;}};
+
+// -----------------
+// sorted_vector_row
+// -----------------
+
+/**
+ * out-edges of one vertex under small_vectorS<N>
+ */
+template <typename V, std::size_t N>
+class sorted_vector_row {
+    private:
+        small_vector<V, N> _v;
+
+    public:
+        typedef typename small_vector<V, N>::const_iterator const_iterator;
+
+        static V max_target () {
+            return std::numeric_limits<V>::max();}
+
+        bool insert (V v) {
+            const_iterator i = std::lower_bound(_v.begin(), _v.end(), v);
+            if ((i != _v.end()) && (*i == v))
+                return false;
+            _v.insert(i, v);
+            return true;}
+
+        bool append (V v) {
+            if (_v.empty() || (_v.back() < v)) {
+                _v.push_back(v);
+                return true;}
+            return insert(v);}
+
+        bool contains (V v) const {
+            const_iterator i = std::lower_bound(_v.begin(), _v.end(), v);
+            return (i != _v.end()) && (*i == v);}
+
+        const_iterator begin      () const {return _v.begin();}
+        const_iterator end        () const {return _v.end();}
+        std::size_t    size       () const {return _v.size();}
+        std::size_t    heap_bytes () const {return _v.heap_bytes();}};
+
+// --------
+// hash_row
+// --------
+
+/**
+ * out-edges of one vertex under hash_setS
+ */
+template <typename V>
+class hash_row {
+    private:
+        std::vector<V>     _v;
+        open_hash_index<V> _index;
+
+    public:
+        typedef const V* const_iterator;
+
+        static V max_target () {
+            return open_hash_index<V>::max_value();}
+
+        bool insert (V v) {
+            if (!_index.insert(v))
+                return false;
+            _v.push_back(v);
+            return true;}
+
+        bool append (V v) {
+            return insert(v);}
+
+        bool           contains (V v) const {return _index.contains(v);}
+        const_iterator begin    ()    const {return _v.data();}
+        const_iterator end      ()    const {return _v.data() + _v.size();}
+        std::size_t    size     ()    const {return _v.size();}
+
+        std::size_t heap_bytes () const {
+            return _v.capacity() * sizeof(V) + _index.heap_bytes();}};
+
+// ------------
+// adaptive_row
+// ------------
+
+/**
+ * out-edges of one vertex under adaptiveS<N, Threshold>
+ */
+template <typename V, std::size_t N, std::size_t Threshold>
+class adaptive_row {
+    private:
+        small_vector<V, N>                  _v;
+        std::unique_ptr<open_hash_index<V> > _index; // set once size() > Threshold
+
+        void promote () {
+            _index.reset(new open_hash_index<V>(2 * _v.size()));
+            for (const V* i = _v.begin(); i != _v.end(); ++i)
+                _index->insert(*i);}
+
+    public:
+        typedef const V* const_iterator;
+
+        static V max_target () {
+            return open_hash_index<V>::max_value();}
+
+        adaptive_row () {}
+
+        adaptive_row (const adaptive_row& that) :
+                _v     (that._v),
+                _index (that._index ? new open_hash_index<V>(*that._index) : 0)
+            {}
+
+        adaptive_row (adaptive_row&& that) noexcept :
+                _v     (std::move(that._v)),
+                _index (std::move(that._index))
+            {}
+
+        adaptive_row& operator = (adaptive_row that) noexcept {
+            _v.swap(that._v);
+            _index.swap(that._index);
+            return *this;}
+
+        /**
+         * @return whether the row has switched to hashed lookups
+         */
+        bool promoted () const {
+            return static_cast<bool>(_index);}
+
+        bool insert (V v) {
+            if (_index) {
+                if (!_index->insert(v))
+                    return false;
+                _v.push_back(v);
+                return true;}
+            const V* i = std::lower_bound(_v.begin(), _v.end(), v);
+            if ((i != _v.end()) && (*i == v))
+                return false;
+            _v.insert(i, v);
+            if (_v.size() > Threshold)
+                promote();
+            return true;}
+
+        bool append (V v) {
+            if (!_index && (_v.empty() || (_v.back() < v))) {
+                _v.push_back(v);
+                if (_v.size() > Threshold)
+                    promote();
+                return true;}
+            return insert(v);}
+
+        bool contains (V v) const {
+            if (_index)
+                return _index->contains(v);
+            const V* i = std::lower_bound(_v.begin(), _v.end(), v);
+            return (i != _v.end()) && (*i == v);}
+
+        const_iterator begin () const {return _v.begin();}
+        const_iterator end   () const {return _v.end();}
+        std::size_t    size  () const {return _v.size();}
+
+        std::size_t heap_bytes () const {
+            return _v.heap_bytes() + (_index ? sizeof(*_index) + _index->heap_bytes() : 0);}};
+
+// ------------
+// out_edge_row
+// ------------
+
+/**
+ * maps a selector to the row type that holds one vertex's out-edges
+ */
+template <typename S, typename V>
+struct out_edge_row;
+
+template <typename V>
+struct out_edge_row<ordered_setS, V> {
+    typedef set_row<V> type;};
+
+template <std::size_t N, typename V>
+struct out_edge_row<small_vectorS<N>, V> {
+    typedef sorted_vector_row<V, N> type;};
+
+template <typename V>
+struct out_edge_row<hash_setS, V> {
+    typedef hash_row<V> type;};
+
+template <std::size_t N, std::size_t Threshold, typename V>
+struct out_edge_row<adaptiveS<N, Threshold>, V> {
+    typedef adaptive_row<V, N, Threshold> type;};
+
+#endif // OutEdgeStorage_h
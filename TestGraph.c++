@@ -37,16 +37,32 @@ To obtain coverage of the test:
 // includes
 // --------
 
-#include <iostream> // cout, endl
-#include <iterator> // ostream_iterator
-#include <sstream>  // ostringstream
-#include <utility>  // pair
+#include <algorithm> // count, equal, min, max, reverse, set_intersection, sort
+#include <atomic>    // atomic
+#include <chrono>    // steady_clock
+#include <cstdio>    // remove
+#include <cstring>   // memcpy
+#include <cstdint>   // uint16_t
+#include <fstream>   // fstream, ofstream
+#include <iostream>  // cout, endl
+#include <iterator>  // back_inserter, distance, ostream_iterator
+#include <sstream>   // ostringstream
+#include <stdexcept> // runtime_error
+#include <string>    // string
+#include <thread>    // thread
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
 
 #include "boost/graph/adjacency_list.hpp"  // adjacency_list
+#include "boost/graph/breadth_first_search.hpp" // breadth_first_search
 #include "boost/graph/topological_sort.hpp"// topological_sort
 
 #include "gtest/gtest.h"
 
+#include "ConcurrentGraph.h"
+#include "CsrGraph.h"
+#include "EdgeList.h"
+#include "GraphAlgorithms.h"
 #include "Graph.h"
 
 // ---------
@@ -73,7 +89,12 @@ struct TestGraph : testing::Test {
 // possibly cyclic
 typedef testing::Types<
             boost::adjacency_list<boost::setS, boost::vecS, boost::directedS>,
-            Graph>
+            Graph,
+            BasicGraph<small_vectorS<> >,
+            BasicGraph<hash_setS>,
+            BasicGraph<adaptiveS<2, 4> >,
+            BasicGraph<ordered_setS, compactS<> >,
+            BasicGraph<small_vectorS<>, compactS<std::uint16_t> > >
         my_types;
 
 TYPED_TEST_CASE(TestGraph, my_types);
@@ -974,4 +995,1240 @@ TYPED_TEST(TestGraph, Adjacent_Vertices) {
         vertex_descriptor vd = *b;
         ASSERT_EQ(vdC, vd);}
     ++b;
-    ASSERT_EQ(e, b);}
\ No newline at end of file
+    ASSERT_EQ(e, b);}
+
+// ---------------
+// TestFrozenGraph
+// ---------------
+
+// graphs that cannot be mutated are built through builder_type and then converted
+template <typename G>
+struct GraphBuilder {
+    typedef G builder_type;
+
+    static const G& build (const G& g) {
+        return g;}};
+
+template <>
+struct GraphBuilder<CsrGraph> {
+    typedef Graph builder_type;
+
+    static CsrGraph build (const Graph& g) {
+        return freeze(g);}};
+
+template <typename G>
+struct TestFrozenGraph : testing::Test {
+    // --------
+    // typedefs
+    // --------
+
+    typedef          G                                 graph_type;
+    typedef typename GraphBuilder<G>::builder_type     builder_type;
+    typedef typename G::vertex_descriptor              vertex_descriptor;
+    typedef typename G::edge_descriptor                edge_descriptor;
+    typedef typename G::vertex_iterator                vertex_iterator;
+    typedef typename G::edge_iterator                  edge_iterator;
+    typedef typename G::adjacency_iterator             adjacency_iterator;
+    typedef typename G::vertices_size_type             vertices_size_type;
+    typedef typename G::edges_size_type                edges_size_type;};
+
+// read-only interface shared by mutable and frozen graphs
+typedef testing::Types<
+            boost::adjacency_list<boost::setS, boost::vecS, boost::directedS>,
+            Graph,
+            CsrGraph>
+        my_frozen_types;
+
+TYPED_TEST_CASE(TestFrozenGraph, my_frozen_types);
+
+TYPED_TEST(TestFrozenGraph, empty){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_iterator    vertex_iterator;
+    typedef typename TestFixture::edge_iterator      edge_iterator;
+
+    builder_type b;
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    ASSERT_EQ(0, num_vertices(g));
+    ASSERT_EQ(0, num_edges(g));
+    std::pair<vertex_iterator, vertex_iterator> p = vertices(g);
+    ASSERT_EQ(p.first, p.second);
+    std::pair<edge_iterator, edge_iterator> q = edges(g);
+    ASSERT_EQ(q.first, q.second);
+}
+
+TYPED_TEST(TestFrozenGraph, vertices){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+    typedef typename TestFixture::vertex_iterator    vertex_iterator;
+
+    builder_type b;
+    add_vertex(b);
+    add_edge(0, 9, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    ASSERT_EQ(10, num_vertices(g));
+    std::pair<vertex_iterator, vertex_iterator> p = vertices(g);
+    vertex_iterator bv = p.first;
+    vertex_iterator ev = p.second;
+    for(int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(i, *bv);
+        ASSERT_EQ(i, vertex(i, g));
+        ++bv;
+    }
+    ASSERT_EQ(bv, ev);
+    --ev;
+    ASSERT_EQ(9, *ev);
+}
+
+TYPED_TEST(TestFrozenGraph, adjacent_vertices){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::adjacency_iterator adjacency_iterator;
+
+    builder_type b;
+    for(int i = 0; i < 5; ++i)
+        add_vertex(b);
+    add_edge(0, 4, b);
+    add_edge(0, 1, b);
+    add_edge(0, 3, b);
+    add_edge(2, 0, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(0, g);
+    adjacency_iterator ba = p.first;
+    ASSERT_EQ(1, *ba++);
+    ASSERT_EQ(3, *ba++);
+    ASSERT_EQ(4, *ba++);
+    ASSERT_EQ(p.second, ba);
+
+    std::pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(1, g);
+    ASSERT_EQ(q.first, q.second);
+
+    std::pair<adjacency_iterator, adjacency_iterator> r = adjacent_vertices(2, g);
+    ASSERT_EQ(0, *r.first);
+}
+
+TYPED_TEST(TestFrozenGraph, edge){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::edge_descriptor    edge_descriptor;
+
+    builder_type b;
+    add_vertex(b);
+    for(int i = 1; i < 100; i += 2)
+        add_edge(0, i, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    for(int i = 0; i < 100; ++i)
+    {
+        std::pair<edge_descriptor, bool> p = edge(0, i, g);
+        ASSERT_EQ(i % 2 == 1, p.second);
+        if (p.second)
+        {
+            ASSERT_EQ(0, source(p.first, g));
+            ASSERT_EQ(i, target(p.first, g));
+        }
+    }
+    ASSERT_FALSE(edge(1, 0, g).second);
+}
+
+TYPED_TEST(TestFrozenGraph, edges){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::edge_descriptor    edge_descriptor;
+    typedef typename TestFixture::edge_iterator      edge_iterator;
+
+    builder_type b;
+    for(int i = 0; i < 4; ++i)
+        add_vertex(b);
+    add_edge(0, 2, b);
+    add_edge(0, 1, b);
+    add_edge(3, 0, b);
+    add_edge(3, 3, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    ASSERT_EQ(4, num_edges(g));
+    std::vector<std::pair<int, int> > x;
+    std::pair<edge_iterator, edge_iterator> p = edges(g);
+    for(edge_iterator be = p.first; be != p.second; ++be)
+    {
+        edge_descriptor ed = *be;
+        x.push_back(std::make_pair((int)source(ed, g), (int)target(ed, g)));
+    }
+    std::sort(x.begin(), x.end());
+    ASSERT_EQ(std::make_pair(0, 1), x[0]);
+    ASSERT_EQ(std::make_pair(0, 2), x[1]);
+    ASSERT_EQ(std::make_pair(3, 0), x[2]);
+    ASSERT_EQ(std::make_pair(3, 3), x[3]);
+}
+
+TYPED_TEST(TestFrozenGraph, topological_sort){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    builder_type b;
+    for(int i = 0; i < 5; ++i)
+        add_vertex(b);
+    add_edge(0, 2, b);
+    add_edge(1, 2, b);
+    add_edge(2, 3, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    topological_sort_result<vertex_descriptor> r = ::topological_sort(g);
+    ASSERT_TRUE(r.is_dag());
+    ASSERT_EQ(5, r.order.size());
+    ASSERT_EQ(0, r.order[0]);
+    ASSERT_EQ(1, r.order[1]);
+    ASSERT_EQ(4, r.order[2]);
+    ASSERT_EQ(2, r.order[3]);
+    ASSERT_EQ(3, r.order[4]);
+}
+
+TYPED_TEST(TestFrozenGraph, topological_sort2){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+    typedef typename TestFixture::edge_descriptor    edge_descriptor;
+    typedef typename TestFixture::edge_iterator      edge_iterator;
+
+    // random DAG: every edge goes from a smaller to a larger label under a shuffled labelling
+    const int n = 500;
+    std::vector<int> label(n);
+    for(int i = 0; i < n; ++i)
+        label[i] = (i * 211) % n;
+    builder_type b;
+    boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> ref(n);
+    for(int i = 0; i < n; ++i)
+        add_vertex(b);
+    unsigned x = 12345;
+    for(int i = 0; i < 4 * n; ++i)
+    {
+        x = x * 1103515245 + 12345;
+        const int u = (x >> 8) % n;
+        x = x * 1103515245 + 12345;
+        const int v = (x >> 8) % n;
+        if (label[u] < label[v])
+        {
+            add_edge(u, v, b);
+            add_edge(u, v, ref);
+        }
+    }
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    ThreadPool pool(4);
+    topological_sort_result<vertex_descriptor> r = ::topological_sort(g, pool);
+    ASSERT_TRUE(r.is_dag());
+    ASSERT_EQ(n, r.order.size());
+
+    std::vector<std::size_t> boost_order;
+    boost::topological_sort(ref, std::back_inserter(boost_order));
+    std::reverse(boost_order.begin(), boost_order.end());
+    ASSERT_EQ(r.order.size(), boost_order.size());
+
+    std::vector<int> mine(n), theirs(n);
+    for(int i = 0; i < n; ++i)
+    {
+        mine[r.order[i]]     = i;
+        theirs[boost_order[i]] = i;
+    }
+    std::pair<edge_iterator, edge_iterator> p = edges(g);
+    for(; p.first != p.second; ++p.first)
+    {
+        edge_descriptor ed = *p.first;
+        ASSERT_LT(mine[source(ed, g)],   mine[target(ed, g)]);
+        ASSERT_LT(theirs[source(ed, g)], theirs[target(ed, g)]);
+    }
+
+    topological_sort_result<vertex_descriptor> q = ::topological_sort(g);
+    ASSERT_TRUE(q.order == r.order);
+}
+
+TYPED_TEST(TestFrozenGraph, topological_sort3){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    builder_type b;
+    for(int i = 0; i < 6; ++i)
+        add_vertex(b);
+    add_edge(0, 1, b);
+    add_edge(1, 2, b);
+    add_edge(2, 0, b);
+    add_edge(2, 3, b);
+    add_edge(4, 0, b);
+    add_edge(4, 5, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    topological_sort_result<vertex_descriptor> r = ::topological_sort(g);
+    ASSERT_FALSE(r.is_dag());
+    ASSERT_EQ(2, r.order.size());
+    ASSERT_EQ(4, r.order[0]);
+    ASSERT_EQ(5, r.order[1]);
+    ASSERT_EQ(4, r.unplaced.size());
+    ASSERT_EQ(0, r.unplaced[0]);
+    ASSERT_EQ(1, r.unplaced[1]);
+    ASSERT_EQ(2, r.unplaced[2]);
+    ASSERT_EQ(3, r.unplaced[3]);
+    // 3 is only downstream of the cycle
+    ASSERT_EQ(3, r.cyclic.size());
+    ASSERT_EQ(0, r.cyclic[0]);
+    ASSERT_EQ(1, r.cyclic[1]);
+    ASSERT_EQ(2, r.cyclic[2]);
+}
+
+TYPED_TEST(TestFrozenGraph, topological_sort4){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    // cycle 0 - 1, a bridge 2 to cycle 3 - 4, a self-loop on 5 and a tail 6
+    builder_type b;
+    for(int i = 0; i < 8; ++i)
+        add_vertex(b);
+    add_edge(0, 1, b);
+    add_edge(1, 0, b);
+    add_edge(1, 2, b);
+    add_edge(2, 3, b);
+    add_edge(3, 4, b);
+    add_edge(4, 3, b);
+    add_edge(4, 5, b);
+    add_edge(5, 5, b);
+    add_edge(5, 6, b);
+    add_edge(7, 0, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    topological_sort_result<vertex_descriptor> r = ::topological_sort(g);
+    ASSERT_FALSE(r.is_dag());
+    ASSERT_EQ(1, r.order.size());
+    ASSERT_EQ(7, r.unplaced.size());
+    const vertex_descriptor expected[] = {0, 1, 3, 4, 5};
+    ASSERT_EQ(5, r.cyclic.size());
+    ASSERT_TRUE(std::equal(r.cyclic.begin(), r.cyclic.end(), expected));
+}
+
+TYPED_TEST(TestFrozenGraph, breadth_first_search){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    builder_type b;
+    for(int i = 0; i < 6; ++i)
+        add_vertex(b);
+    add_edge(0, 1, b);
+    add_edge(0, 2, b);
+    add_edge(2, 3, b);
+    add_edge(3, 0, b);
+    add_edge(5, 4, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    bfs_result<vertex_descriptor> r = ::breadth_first_search(g, 0);
+    ASSERT_EQ( 0, r.distance[0]);
+    ASSERT_EQ( 1, r.distance[1]);
+    ASSERT_EQ( 1, r.distance[2]);
+    ASSERT_EQ( 2, r.distance[3]);
+    ASSERT_EQ(-1, r.distance[4]);
+    ASSERT_EQ(-1, r.distance[5]);
+    ASSERT_EQ(0, r.parent[0]);
+    ASSERT_EQ(0, r.parent[1]);
+    ASSERT_EQ(2, r.parent[3]);
+    ASSERT_EQ(4, r.parent[4]);
+}
+
+TYPED_TEST(TestFrozenGraph, breadth_first_search3){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    builder_type b;
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    bfs_result<vertex_descriptor> r = ::breadth_first_search(g, 0);
+    ASSERT_TRUE(r.distance.empty());
+    ASSERT_TRUE(r.parent.empty());
+    ASSERT_EQ(0, r.bottom_up_levels);
+}
+
+TYPED_TEST(TestFrozenGraph, breadth_first_search2){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    // a few hubs make the middle levels large enough to go bottom-up
+    const int n = 3000;
+    builder_type b;
+    boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> ref(n);
+    for(int i = 0; i < n; ++i)
+        add_vertex(b);
+    unsigned x = 777;
+    for(int i = 0; i < 6 * n; ++i)
+    {
+        x = x * 1103515245 + 12345;
+        const int u = (i % 3 == 0) ? (x >> 8) % 8 : (x >> 8) % n;
+        x = x * 1103515245 + 12345;
+        const int v = (x >> 8) % n;
+        add_edge(u, v, b);
+        add_edge(u, v, ref);
+    }
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    std::vector<int> d(n, -1);
+    d[1] = 0;
+    boost::breadth_first_search(ref, 1,
+        boost::visitor(boost::make_bfs_visitor(boost::record_distances(&d[0], boost::on_tree_edge()))));
+
+    ThreadPool pool(3);
+    bfs_result<vertex_descriptor> r = ::breadth_first_search(g, 1, pool);
+    ASSERT_GT(r.bottom_up_levels, 0);
+    ASSERT_TRUE(r.distance == d);
+    for(int v = 0; v < n; ++v)
+        if (d[v] > 0)
+        {
+            ASSERT_EQ(d[v], d[r.parent[v]] + 1);
+            ASSERT_TRUE(edge(r.parent[v], v, g).second);
+        }
+
+    bfs_result<vertex_descriptor> q = ::breadth_first_search(g, 1, pool, 1e-9);
+    ASSERT_EQ(0, q.bottom_up_levels);
+    ASSERT_TRUE(q.distance == d);
+}
+
+TYPED_TEST(TestFrozenGraph, common_neighbors){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    builder_type b;
+    for(int i = 0; i < 6; ++i)
+        add_vertex(b);
+    add_edge(0, 3, b);
+    add_edge(0, 1, b);
+    add_edge(0, 2, b);
+    add_edge(4, 5, b);
+    add_edge(4, 3, b);
+    add_edge(4, 2, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    std::vector<vertex_descriptor> c = common_neighbors(0, 4, g);
+    ASSERT_EQ(2, c.size());
+    ASSERT_EQ(2, c[0]);
+    ASSERT_EQ(3, c[1]);
+    ASSERT_TRUE(common_neighbors(0, 5, g).empty());
+    ASSERT_EQ(3, common_neighbors(0, 0, g).size());
+}
+
+TYPED_TEST(TestFrozenGraph, count_triangles){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+
+    // K4 on 0..3, with a reciprocal edge, a self-loop and a tail 3 - 4
+    builder_type b;
+    for(int i = 0; i < 5; ++i)
+        add_vertex(b);
+    add_edge(0, 1, b);
+    add_edge(1, 2, b);
+    add_edge(2, 0, b);
+    add_edge(0, 3, b);
+    add_edge(3, 1, b);
+    add_edge(2, 3, b);
+    add_edge(1, 0, b);
+    add_edge(2, 2, b);
+    add_edge(3, 4, b);
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    ASSERT_EQ(4, count_triangles(g));
+    std::vector<double> c = local_clustering(g);
+    ASSERT_EQ(5, c.size());
+    ASSERT_DOUBLE_EQ(1.0, c[0]);
+    ASSERT_DOUBLE_EQ(1.0, c[1]);
+    ASSERT_DOUBLE_EQ(1.0, c[2]);
+    ASSERT_DOUBLE_EQ(0.5, c[3]);
+    ASSERT_DOUBLE_EQ(0.0, c[4]);
+}
+
+TYPED_TEST(TestFrozenGraph, count_triangles2){
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::builder_type       builder_type;
+
+    const int n = 200;
+    builder_type b;
+    std::vector<std::vector<bool> > a(n, std::vector<bool>(n, false));
+    for(int i = 0; i < n; ++i)
+        add_vertex(b);
+    unsigned x = 4242;
+    for(int i = 0; i < 8 * n; ++i)
+    {
+        x = x * 1103515245 + 12345;
+        const int u = (i % 4 == 0) ? (x >> 8) % 5 : (x >> 8) % n;
+        x = x * 1103515245 + 12345;
+        const int v = (x >> 8) % n;
+        add_edge(u, v, b);
+        if (u != v)
+            a[u][v] = a[v][u] = true;
+    }
+    const graph_type& g = GraphBuilder<graph_type>::build(b);
+
+    std::size_t t = 0;
+    std::vector<std::size_t> through(n, 0);
+    for(int i = 0; i < n; ++i)
+        for(int j = i + 1; j < n; ++j)
+            for(int k = j + 1; k < n; ++k)
+                if (a[i][j] && a[j][k] && a[i][k])
+                {
+                    ++t;
+                    ++through[i];
+                    ++through[j];
+                    ++through[k];
+                }
+
+    ThreadPool pool(3);
+    ASSERT_EQ(t, count_triangles(g, pool));
+    std::vector<double> c = local_clustering(g, pool);
+    for(int v = 0; v < n; ++v)
+    {
+        const double d = static_cast<double>(std::count(a[v].begin(), a[v].end(), true));
+        ASSERT_DOUBLE_EQ(d < 2 ? 0.0 : 2 * through[v] / (d * (d - 1)), c[v]);
+    }
+}
+
+TEST(TestCsrGraph, freeze){
+    Graph g;
+    add_vertex(g);
+    for(int i = 10; i > 0; --i)
+        add_edge(0, i, g);
+    add_edge(5, 2, g);
+
+    CsrGraph c = freeze(g);
+    ASSERT_EQ(num_vertices(g), num_vertices(c));
+    ASSERT_EQ(num_edges(g),    num_edges(c));
+
+    for(int u = 0; u < (int)num_vertices(g); ++u)
+    {
+        std::pair<Graph::adjacency_iterator, Graph::adjacency_iterator> p = adjacent_vertices(u, g);
+        std::pair<CsrGraph::adjacency_iterator, CsrGraph::adjacency_iterator> q = adjacent_vertices(u, c);
+        ASSERT_TRUE(std::equal(p.first, p.second, q.first));
+        ASSERT_EQ(std::distance(p.first, p.second), q.second - q.first);
+    }
+}
+
+TEST(TestCsrGraph, edges_order){
+    Graph g;
+    add_vertex(g);
+    add_edge(0, 3, g);
+    add_edge(2, 1, g);
+    add_edge(0, 1, g);
+    add_edge(3, 0, g);
+
+    CsrGraph c = freeze(g);
+    std::pair<CsrGraph::edge_iterator, CsrGraph::edge_iterator> p = edges(c);
+    CsrGraph::edge_iterator b = p.first;
+    ASSERT_EQ(std::make_pair(0, 1), *b++);
+    ASSERT_EQ(std::make_pair(0, 3), *b++);
+    ASSERT_EQ(std::make_pair(2, 1), *b++);
+    ASSERT_EQ(std::make_pair(3, 0), *b++);
+    ASSERT_EQ(p.second, b);
+}
+
+// -------------
+// TestGraphBulk
+// -------------
+
+TEST(TestGraphBulk, add_edges){
+    std::vector<Graph::edge_descriptor> x;
+    x.push_back(std::make_pair(2, 1));
+    x.push_back(std::make_pair(0, 3));
+    x.push_back(std::make_pair(0, 1));
+    x.push_back(std::make_pair(2, 1));
+    x.push_back(std::make_pair(0, 3));
+
+    Graph g;
+    ASSERT_EQ(2, add_edges(x.begin(), x.end(), g));
+    ASSERT_EQ(4, num_vertices(g));
+    ASSERT_EQ(3, num_edges(g));
+    ASSERT_TRUE(edge(0, 1, g).second);
+    ASSERT_TRUE(edge(0, 3, g).second);
+    ASSERT_TRUE(edge(2, 1, g).second);
+    ASSERT_FALSE(edge(1, 2, g).second);
+}
+
+TEST(TestGraphBulk, add_edges2){
+    Graph g;
+    add_vertex(g);
+    add_edge(0, 5, g);
+
+    std::vector<Graph::edge_descriptor> x;
+    x.push_back(std::make_pair(0, 5));
+    x.push_back(std::make_pair(0, 2));
+    x.push_back(std::make_pair(7, 0));
+
+    ASSERT_EQ(1, add_edges(x.begin(), x.end(), g));
+    ASSERT_EQ(8, num_vertices(g));
+    ASSERT_EQ(3, num_edges(g));
+    ASSERT_EQ(0, add_edges(x.end(), x.end(), g));
+}
+
+TEST(TestGraphBulk, add_edges3){
+    std::vector<Graph::edge_descriptor> x;
+    for(int i = 0; i < 1000; ++i)
+        x.push_back(std::make_pair((i * 7919) % 97, (i * 104729) % 89));
+
+    Graph a;
+    int dropped = 0;
+    for(std::size_t i = 0; i < x.size(); ++i)
+        if (!add_edge(x[i].first, x[i].second, a).second)
+            ++dropped;
+
+    Graph b;
+    ASSERT_EQ(dropped, add_edges(x.begin(), x.end(), b));
+    ASSERT_EQ(num_vertices(a), num_vertices(b));
+    ASSERT_EQ(num_edges(a),    num_edges(b));
+    for(int u = 0; u < (int)num_vertices(a); ++u)
+    {
+        std::pair<Graph::adjacency_iterator, Graph::adjacency_iterator> p = adjacent_vertices(u, a);
+        std::pair<Graph::adjacency_iterator, Graph::adjacency_iterator> q = adjacent_vertices(u, b);
+        ASSERT_EQ(std::distance(p.first, p.second), std::distance(q.first, q.second));
+        ASSERT_TRUE(std::equal(p.first, p.second, q.first));
+    }
+}
+
+TEST(TestGraphBulk, constructor){
+    std::vector<Graph::edge_descriptor> x;
+    x.push_back(std::make_pair(1, 0));
+    x.push_back(std::make_pair(1, 0));
+    x.push_back(std::make_pair(0, 4));
+
+    Graph g(x.begin(), x.end());
+    ASSERT_EQ(5, num_vertices(g));
+    ASSERT_EQ(2, num_edges(g));
+
+    std::pair<Graph::edge_iterator, Graph::edge_iterator> p = edges(g);
+    Graph::edge_iterator b = p.first;
+    ASSERT_EQ(std::make_pair(0, 4), *b++);
+    ASSERT_EQ(std::make_pair(1, 0), *b++);
+    ASSERT_EQ(p.second, b);
+}
+
+TEST(TestCsrGraph, save_open){
+    Graph g;
+    add_vertex(g);
+    for(int i = 0; i < 50; ++i)
+        add_edge((i * 7) % 13, (i * 11) % 17, g);
+    add_vertex(g);
+
+    const std::string path = testing::TempDir() + "TestGraph.csr";
+    save(g, path);
+    CsrGraph c = CsrGraph::open(path);
+
+    ASSERT_EQ(num_vertices(g), num_vertices(c));
+    ASSERT_EQ(num_edges(g),    num_edges(c));
+
+    std::vector<Graph::edge_descriptor> x(edges(g).first, edges(g).second);
+    std::sort(x.begin(), x.end());
+    std::pair<CsrGraph::edge_iterator, CsrGraph::edge_iterator> p = edges(c);
+    ASSERT_TRUE(std::equal(x.begin(), x.end(), p.first));
+
+    for(int u = 0; u < (int)num_vertices(g); ++u)
+    {
+        std::pair<Graph::adjacency_iterator, Graph::adjacency_iterator> q = adjacent_vertices(u, g);
+        std::pair<CsrGraph::adjacency_iterator, CsrGraph::adjacency_iterator> r = adjacent_vertices(u, c);
+        ASSERT_EQ(std::distance(q.first, q.second), r.second - r.first);
+        ASSERT_TRUE(std::equal(q.first, q.second, r.first));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(TestCsrGraph, save_open2){
+    const std::string path = testing::TempDir() + "TestGraph.csr";
+    save(CsrGraph(), path);
+    CsrGraph c = CsrGraph::open(path);
+    ASSERT_EQ(0, num_vertices(c));
+    ASSERT_EQ(0, num_edges(c));
+
+    CsrGraph d = c;
+    ASSERT_EQ(edges(d).first, edges(d).second);
+    std::remove(path.c_str());
+}
+
+TEST(TestCsrGraph, open_corrupt){
+    Graph g;
+    add_edge(0, 3, g);
+    add_edge(3, 1, g);
+    const std::string path = testing::TempDir() + "TestGraph.csr";
+    save(g, path);
+    {
+        std::fstream f(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        // the last target becomes vertex 2, still a well-formed graph
+        f.seekp(-4, std::ios::end);
+        f.put(2);
+    }
+    ASSERT_THROW(CsrGraph::open(path), std::runtime_error);
+    ASSERT_NO_THROW(CsrGraph::open(path, false));
+    std::remove(path.c_str());
+}
+
+TEST(TestCsrGraph, open_bad_header){
+    const std::string path = testing::TempDir() + "TestGraph.csr";
+    {
+        std::ofstream f(path.c_str(), std::ios::binary);
+        f << "this is not a graph file at all, just some text";
+    }
+    ASSERT_THROW(CsrGraph::open(path), std::runtime_error);
+    std::remove(path.c_str());
+    ASSERT_THROW(CsrGraph::open(path), std::runtime_error);
+}
+
+/**
+ * writes a CsrGraph file with the given arrays and a correct checksum
+ */
+void write_csr (const std::string& path, const std::vector<CsrGraph::offset_type>& o, const std::vector<int>& t, std::uint64_t n, std::uint64_t m) {
+    csr_file_header h;
+    std::memcpy(h.magic, csr_file_magic, sizeof(h.magic));
+    h.version      = csr_file_version;
+    h.endian       = csr_file_endian;
+    h.num_vertices = n;
+    h.num_edges    = m;
+    h.checksum     = csr_checksum(o.data(), o.size() - 1, t.data(), t.size());
+    std::ofstream f(path.c_str(), std::ios::binary);
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(reinterpret_cast<const char*>(o.data()), o.size() * sizeof(CsrGraph::offset_type));
+    f.write(reinterpret_cast<const char*>(t.data()), t.size() * sizeof(int));}
+
+TEST(TestCsrGraph, open_malformed){
+    const std::string path = testing::TempDir() + "TestGraph.csr";
+    std::vector<CsrGraph::offset_type> o;
+    o.push_back(0);
+    o.push_back(400000000);
+    o.push_back(1);
+    std::vector<int> t(1, 0);
+    write_csr(path, o, t, 2, 1);
+    ASSERT_THROW(CsrGraph::open(path), std::runtime_error);
+
+    o[1] = 1;
+    t[0] = 7;
+    write_csr(path, o, t, 2, 1);
+    ASSERT_THROW(CsrGraph::open(path), std::runtime_error);
+
+    t[0] = 1;
+    write_csr(path, o, t, 2, 1);
+    ASSERT_EQ(1, num_edges(CsrGraph::open(path)));
+
+    // counts whose byte sizes wrap around to exactly the file size
+    write_csr(path, o, t, 0x2000000000000002ULL, 1);
+    ASSERT_THROW(CsrGraph::open(path), std::runtime_error);
+    write_csr(path, o, t, 2, 0x4000000000000001ULL);
+    ASSERT_THROW(CsrGraph::open(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+// ------------
+// TestEdgeList
+// ------------
+
+TEST(TestEdgeList, read){
+    const std::string s =
+        "# Directed graph\n"
+        "# FromNodeId\tToNodeId\n"
+        "0\t1\n"
+        "\n"
+        "0 2\n"
+        "  3   0  \r\n"
+        "% matrix market style comment\n"
+        "0\t1\n"
+        "2 3 17.5 1408000000\n"
+        "1 1";
+    edge_list_stats stats;
+    Graph g = read_edge_list(s.data(), s.data() + s.size(), edge_list_options(), &stats);
+
+    ASSERT_EQ(4, num_vertices(g));
+    ASSERT_EQ(5, num_edges(g));
+    ASSERT_TRUE(edge(0, 1, g).second);
+    ASSERT_TRUE(edge(0, 2, g).second);
+    ASSERT_TRUE(edge(3, 0, g).second);
+    ASSERT_TRUE(edge(2, 3, g).second);
+    ASSERT_TRUE(edge(1, 1, g).second);
+    ASSERT_EQ(s.size(), stats.bytes);
+    ASSERT_EQ(6, stats.edges);
+    ASSERT_EQ(1, stats.duplicates);
+    ASSERT_TRUE(stats.ids.empty());
+}
+
+TEST(TestEdgeList, read_threads){
+    std::ostringstream out;
+    out << "# generated\n";
+    Graph a;
+    for(int i = 0; i < 5000; ++i)
+    {
+        const int u = (i * 7919) % 503;
+        const int v = (i * 104729) % 499;
+        out << u << ' ' << v << '\n';
+        add_edge(u, v, a);
+    }
+    const std::string s = out.str();
+
+    for(unsigned t = 1; t <= 8; ++t)
+    {
+        edge_list_options opts;
+        opts.threads = t;
+        edge_list_stats stats;
+        Graph g = read_edge_list(s.data(), s.data() + s.size(), opts, &stats);
+        ASSERT_EQ(t, stats.threads);
+        ASSERT_EQ(5000, stats.edges);
+        ASSERT_EQ(num_vertices(a), num_vertices(g));
+        ASSERT_EQ(num_edges(a),    num_edges(g));
+        for(int u = 0; u < (int)num_vertices(a); ++u)
+        {
+            std::pair<Graph::adjacency_iterator, Graph::adjacency_iterator> p = adjacent_vertices(u, a);
+            std::pair<Graph::adjacency_iterator, Graph::adjacency_iterator> q = adjacent_vertices(u, g);
+            ASSERT_EQ(std::distance(p.first, p.second), std::distance(q.first, q.second));
+            ASSERT_TRUE(std::equal(p.first, p.second, q.first));
+        }
+    }
+}
+
+TEST(TestEdgeList, read_remap){
+    const std::string s =
+        "1000000000000 42\n"
+        "-7 1000000000000\n"
+        "42 -7\n";
+    edge_list_options opts;
+    opts.remap = true;
+    edge_list_stats stats;
+    Graph g = read_edge_list(s.data(), s.data() + s.size(), opts, &stats);
+
+    ASSERT_EQ(3, num_vertices(g));
+    ASSERT_EQ(3, num_edges(g));
+    ASSERT_EQ(3, stats.ids.size());
+    ASSERT_EQ(-7,             stats.ids[0]);
+    ASSERT_EQ(42,             stats.ids[1]);
+    ASSERT_EQ(1000000000000LL, stats.ids[2]);
+    ASSERT_TRUE(edge(2, 1, g).second);
+    ASSERT_TRUE(edge(0, 2, g).second);
+    ASSERT_TRUE(edge(1, 0, g).second);
+}
+
+TEST(TestEdgeList, read_errors){
+    const std::string s = "0 1\n2 x\n";
+    ASSERT_THROW(read_edge_list(s.data(), s.data() + s.size()), std::runtime_error);
+
+    const std::string t = "0 -1\n";
+    ASSERT_THROW(read_edge_list(t.data(), t.data() + t.size()), std::runtime_error);
+
+    ASSERT_THROW(read_edge_list(testing::TempDir() + "TestGraph.missing"), std::runtime_error);
+}
+
+TEST(TestEdgeList, read_file){
+    const std::string path = testing::TempDir() + "TestGraph.txt";
+    {
+        std::ofstream f(path.c_str());
+        f << "# Nodes: 3 Edges: 2\n0\t2\n2\t1\n";
+    }
+    edge_list_stats stats;
+    Graph g = read_edge_list(path, edge_list_options(), &stats);
+    ASSERT_EQ(3, num_vertices(g));
+    ASSERT_EQ(2, num_edges(g));
+    ASSERT_TRUE(edge(2, 1, g).second);
+    ASSERT_GE(stats.mb_per_second(), 0);
+    std::remove(path.c_str());
+}
+
+// ------------------
+// TestOutEdgeStorage
+// ------------------
+
+TEST(TestOutEdgeStorage, small_vector){
+    small_vector<int, 2> x;
+    x.push_back(5);
+    x.push_back(1);
+    ASSERT_EQ(2, x.capacity());
+    x.insert(x.begin() + 1, 3);
+    ASSERT_EQ(3, x.size());
+    ASSERT_LT(2, x.capacity());
+
+    small_vector<int, 2> y = x;
+    small_vector<int, 2> z(std::move(x));
+    ASSERT_EQ(0, x.size());
+    ASSERT_TRUE(std::equal(y.begin(), y.end(), z.begin()));
+    ASSERT_EQ(5, y.begin()[0]);
+    ASSERT_EQ(3, y.begin()[1]);
+    ASSERT_EQ(1, y.begin()[2]);
+
+    small_vector<int, 2> w;
+    w.push_back(9);
+    w.swap(y);
+    ASSERT_EQ(1, y.size());
+    ASSERT_EQ(9, y.back());
+    ASSERT_EQ(3, w.size());
+}
+
+TEST(TestOutEdgeStorage, open_hash_index){
+    open_hash_index<int> x;
+    for(int i = 0; i < 1000; i += 3)
+        ASSERT_TRUE(x.insert(i));
+    ASSERT_FALSE(x.insert(999));
+    ASSERT_EQ(334, x.size());
+    ASSERT_LE(2 * x.size(), x.slots());
+    for(int i = 0; i < 1000; ++i)
+        ASSERT_EQ(i % 3 == 0, x.contains(i));
+}
+
+TEST(TestOutEdgeStorage, adaptive_row){
+    adaptive_row<int, 2, 4> r;
+    for(int i = 8; i > 3; --i)
+    {
+        ASSERT_FALSE(r.promoted());
+        ASSERT_TRUE(r.insert(i));
+    }
+    ASSERT_TRUE(r.promoted());
+    ASSERT_TRUE(r.insert(1));
+    ASSERT_FALSE(r.insert(6));
+    ASSERT_TRUE(r.contains(1));
+    ASSERT_FALSE(r.contains(2));
+
+    // sorted until promotion, then in insertion order
+    const int expected[] = {4, 5, 6, 7, 8, 1};
+    ASSERT_EQ(6, r.size());
+    ASSERT_TRUE(std::equal(r.begin(), r.end(), expected));
+
+    adaptive_row<int, 2, 4> s = r;
+    ASSERT_TRUE(s.promoted());
+    ASSERT_TRUE(s.contains(1));
+}
+
+TEST(TestOutEdgeStorage, freeze){
+    BasicGraph<hash_setS> g;
+    add_edge(0, 7, g);
+    add_edge(0, 2, g);
+    add_edge(0, 5, g);
+    add_edge(3, 1, g);
+
+    std::pair<BasicGraph<hash_setS>::adjacency_iterator, BasicGraph<hash_setS>::adjacency_iterator> p = adjacent_vertices(0, g);
+    ASSERT_EQ(7, *p.first);
+
+    CsrGraph c = freeze(g);
+    ASSERT_EQ(8, num_vertices(c));
+    ASSERT_EQ(4, num_edges(c));
+    std::pair<CsrGraph::adjacency_iterator, CsrGraph::adjacency_iterator> q = adjacent_vertices(0, c);
+    const int expected[] = {2, 5, 7};
+    ASSERT_TRUE(std::equal(q.first, q.second, expected));
+}
+
+TEST(TestOutEdgeStorage, add_edges){
+    std::vector<Graph::edge_descriptor> x;
+    for(int i = 0; i < 300; ++i)
+        x.push_back(std::make_pair(i % 3, (i * 37) % 101));
+
+    Graph                         a(x.begin(), x.end());
+    BasicGraph<small_vectorS<4> > b(x.begin(), x.end());
+    BasicGraph<adaptiveS<4, 16> > c(x.begin(), x.end());
+    ASSERT_EQ(num_edges(a), num_edges(b));
+    ASSERT_EQ(num_edges(a), num_edges(c));
+    for(int u = 0; u < 3; ++u)
+    {
+        ASSERT_TRUE(std::equal(adjacent_vertices(u, a).first, adjacent_vertices(u, a).second, adjacent_vertices(u, b).first));
+        ASSERT_TRUE(std::equal(adjacent_vertices(u, a).first, adjacent_vertices(u, a).second, adjacent_vertices(u, c).first));
+    }
+}
+
+// ----------
+// TestLayout
+// ----------
+
+TEST(TestLayout, compact_edges){
+    CompactGraph g;
+    add_edge(2, 0, g);
+    add_edge(0, 3, g);
+    add_edge(0, 1, g);
+    add_edge(2, 1, g);
+
+    ASSERT_EQ(4, num_vertices(g));
+    ASSERT_EQ(4, num_edges(g));
+    std::vector<CompactGraph::edge_descriptor> x(edges(g).first, edges(g).second);
+    std::vector<CompactGraph::edge_descriptor> y;
+    y.push_back(std::make_pair(0, 1));
+    y.push_back(std::make_pair(0, 3));
+    y.push_back(std::make_pair(2, 0));
+    y.push_back(std::make_pair(2, 1));
+    ASSERT_EQ(y, x);
+    ASSERT_EQ(2, *(vertices(g).first + 2));
+}
+
+TEST(TestLayout, compact_constructor){
+    std::vector<CompactGraph::row_type> rows(3);
+    rows[0].insert(2);
+    rows[2].insert(1);
+    CompactGraph g(rows);
+    ASSERT_EQ(3, num_vertices(g));
+    ASSERT_EQ(2, num_edges(g));
+    ASSERT_TRUE(edge(2, 1, g).second);
+}
+
+TEST(TestLayout, max_vertices){
+    typedef BasicGraph<small_vectorS<>, compactS<std::uint16_t> > graph_type;
+    ASSERT_EQ(65535, graph_type::max_vertices());
+    ASSERT_EQ(65535, (BasicGraph<hash_setS, compactS<std::uint16_t> >::max_vertices()));
+    ASSERT_EQ(127, (BasicGraph<ordered_setS, compactS<signed char> >::max_vertices()));
+
+    graph_type g;
+    for(int i = 0; i < 65535; ++i)
+        ASSERT_EQ(i, add_vertex(g));
+    ASSERT_THROW(add_vertex(g), std::length_error);
+    ASSERT_THROW(add_edge(65535, 0, g), std::length_error);
+    ASSERT_EQ(65535, num_vertices(g));
+    ASSERT_EQ(65534, *(vertices(g).second - 1));
+    ASSERT_TRUE(add_edge(65534, 0, g).second);
+
+    BasicGraph<hash_setS, compactS<std::uint16_t> > h;
+    ASSERT_TRUE(add_edge(0, 65534, h).second);
+    ASSERT_TRUE(edge(0, 65534, h).second);
+    ASSERT_THROW(add_edge(0, 65535, h), std::length_error);
+    ASSERT_EQ(1, num_edges(h));
+
+    ConcurrentGraph<small_vectorS<>, compactS<std::uint16_t> > c;
+    ASSERT_THROW(add_edge(65535, 1, c), std::length_error);
+    ASSERT_TRUE(add_edge(65534, 1, c).second);
+    ASSERT_THROW(add_vertex(c), std::length_error);
+}
+
+TEST(TestLayout, memory_usage){
+    std::vector<Graph::edge_descriptor> x;
+    for(int i = 0; i < 1000; ++i)
+        x.push_back(std::make_pair(i % 100, (i * 37) % 1000));
+
+    Graph        a(x.begin(), x.end());
+    CompactGraph b(x.begin(), x.end());
+    graph_memory ma = memory_usage(a);
+    graph_memory mb = memory_usage(b);
+    ASSERT_EQ(1000 * sizeof(int), ma.vertices);
+    ASSERT_EQ(1000 * sizeof(Graph::edge_descriptor), ma.edges);
+    ASSERT_EQ(1000 * sizeof(Graph::row_type), ma.rows);
+    ASSERT_LT(0, ma.adjacency);
+    ASSERT_EQ(0, mb.vertices);
+    ASSERT_EQ(0, mb.edges);
+    ASSERT_LT(mb.total(), ma.total());
+    ASSERT_LT(mb.adjacency, ma.adjacency);
+
+    CsrGraph c = freeze(b);
+    graph_memory mc = memory_usage(c);
+    ASSERT_EQ(1001 * sizeof(CsrGraph::offset_type), mc.rows);
+    ASSERT_EQ(1000 * sizeof(int), mc.adjacency);
+}
+
+// -------------------
+// TestConcurrentGraph
+// -------------------
+
+TEST(TestConcurrentGraph, add_edge){
+    ConcurrentGraph<> c;
+    ASSERT_TRUE(add_edge(0, 3, c).second);
+    ASSERT_FALSE(add_edge(0, 3, c).second);
+    ASSERT_TRUE(add_edge(2000, 1, c).second);
+    ASSERT_EQ(2001, num_vertices(c));
+    ASSERT_EQ(2, num_edges(c));
+    ASSERT_EQ(2001, add_vertex(c));
+
+    Graph g = seal(c);
+    ASSERT_EQ(2002, num_vertices(g));
+    ASSERT_EQ(2, num_edges(g));
+    ASSERT_TRUE(edge(0, 3, g).second);
+    ASSERT_TRUE(edge(2000, 1, g).second);
+    ASSERT_EQ(0, num_vertices(c));
+    ASSERT_EQ(0, num_edges(c));
+}
+
+TEST(TestConcurrentGraph, add_edges){
+    std::vector<Graph::edge_descriptor> x;
+    x.push_back(std::make_pair(1, 2));
+    x.push_back(std::make_pair(1, 0));
+    x.push_back(std::make_pair(1, 2));
+    x.push_back(std::make_pair(5, 4));
+
+    ConcurrentGraph<> c;
+    add_edge(5, 4, c);
+    ASSERT_EQ(2, add_edges(x.begin(), x.end(), c));
+    ASSERT_EQ(3, num_edges(c));
+    Graph g = seal(c);
+    ASSERT_EQ(6, num_vertices(g));
+    std::vector<Graph::edge_descriptor> y(edges(g).first, edges(g).second);
+    std::vector<Graph::edge_descriptor> z;
+    z.push_back(std::make_pair(1, 0));
+    z.push_back(std::make_pair(1, 2));
+    z.push_back(std::make_pair(5, 4));
+    ASSERT_EQ(z, y);
+}
+
+/**
+ * producers threads add x to a ConcurrentGraph, alternating single add_edge calls
+ * with add_edges batches, and the sealed graph must equal a serial build of x
+ */
+template <typename OutEdgeS, typename LayoutS>
+double concurrent_build (const std::vector<std::pair<int, int> >& x, unsigned producers) {
+    typedef BasicGraph<OutEdgeS, LayoutS>             graph_type;
+    typedef typename graph_type::vertex_descriptor    vertex_descriptor;
+    typedef typename graph_type::edge_descriptor      edge_descriptor;
+    typedef typename graph_type::adjacency_iterator   adjacency_iterator;
+
+    std::vector<edge_descriptor> y;
+    for (std::size_t i = 0; i != x.size(); ++i)
+        y.push_back(std::make_pair(static_cast<vertex_descriptor>(x[i].first), static_cast<vertex_descriptor>(x[i].second)));
+    const graph_type serial(y.begin(), y.end());
+
+    ConcurrentGraph<OutEdgeS, LayoutS> c;
+    std::vector<std::size_t>           added(producers);
+    std::vector<std::thread>           threads;
+    const std::size_t                  batch = 512;
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t != producers; ++t)
+        threads.push_back(std::thread([&, t] () {
+            for (std::size_t b = t * batch; b < y.size(); b += producers * batch) {
+                const std::size_t e = std::min(b + batch, y.size());
+                if ((b / batch) % 2 == 0)
+                    for (std::size_t i = b; i != e; ++i)
+                        added[t] += add_edge(y[i].first, y[i].second, c).second;
+                else
+                    added[t] += (e - b) - add_edges(y.begin() + b, y.begin() + e, c);}}));
+    for (unsigned t = 0; t != producers; ++t)
+        threads[t].join();
+    const graph_type g = seal(c);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    std::size_t total = 0;
+    for (unsigned t = 0; t != producers; ++t)
+        total += added[t];
+    EXPECT_EQ(num_edges(serial), total);
+    EXPECT_EQ(num_vertices(serial), num_vertices(g));
+    EXPECT_EQ(num_edges(serial), num_edges(g));
+    for (std::size_t u = 0; u != num_vertices(g); ++u) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(static_cast<vertex_descriptor>(u), serial);
+        std::pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+        std::vector<vertex_descriptor> a(p.first, p.second);
+        std::vector<vertex_descriptor> b(q.first, q.second);
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        EXPECT_EQ(a, b);}
+    return ms;}
+
+TEST(TestConcurrentGraph, stress){
+    std::vector<std::pair<int, int> > x;
+    unsigned long r = 12345;
+    for (int i = 0; i < 100000; ++i) {
+        r = r * 6364136223846793005UL + 1442695040888963407UL;
+        const int u = static_cast<int>((r >> 33) % 20000);
+        r = r * 6364136223846793005UL + 1442695040888963407UL;
+        const int v = static_cast<int>((r >> 33) % 20000);
+        x.push_back(std::make_pair(u, v));}
+    x.insert(x.end(), x.begin(), x.begin() + 25000); // duplicates across producers
+
+    const unsigned n = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned t = 1; t <= n; t *= 2) {
+        std::ostringstream key;
+        key << "ms_" << t << "_threads";
+        RecordProperty(key.str(), static_cast<int>(concurrent_build<ordered_setS, indexedS>(x, t)));
+        concurrent_build<hash_setS, indexedS>(x, t);
+        concurrent_build<small_vectorS<>, compactS<> >(x, t);}
+}
+
+// ----------------
+// TestIntersection
+// ----------------
+
+TEST(TestIntersection, kernels){
+    std::vector<intersect_function> kernels;
+    kernels.push_back(&intersect_scalar);
+    kernels.push_back(&intersect_galloping);
+#ifdef GRAPH_X86_KERNELS
+    kernels.push_back(&intersect_sse);
+    if (cpu_supports_avx2())
+        kernels.push_back(&intersect_avx2);
+#endif
+    kernels.push_back(intersect_kernel());
+
+    unsigned x = 99;
+    const int sizes[] = {0, 1, 3, 4, 7, 8, 9, 17, 64, 100, 1000};
+    for(int i = 0; i < 11; ++i)
+        for(int j = 0; j < 11; ++j)
+            for(int spread = 1; spread <= 4; spread *= 2)
+            {
+                std::vector<std::int32_t> a;
+                std::vector<std::int32_t> b;
+                for(int k = 0, v = 0; k < sizes[i]; ++k)
+                {
+                    x = x * 1103515245 + 12345;
+                    a.push_back(v += 1 + (x >> 8) % spread);
+                }
+                for(int k = 0, v = 0; k < sizes[j]; ++k)
+                {
+                    x = x * 1103515245 + 12345;
+                    b.push_back(v += 1 + (x >> 8) % (2 * spread));
+                }
+                std::vector<std::int32_t> expected;
+                std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+                for(std::size_t f = 0; f < kernels.size(); ++f)
+                {
+                    std::vector<std::int32_t> c(std::min(a.size(), b.size()) + 1, -1);
+                    ASSERT_EQ(expected.size(), kernels[f](a.data(), a.size(), b.data(), b.size(), c.data()));
+                    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), c.begin()));
+                    ASSERT_EQ(expected.size(), kernels[f](a.data(), a.size(), b.data(), b.size(), 0));
+                }
+                ASSERT_EQ(expected.size(), intersect(a.data(), a.size(), b.data(), b.size()));
+                ASSERT_EQ(expected.size(), intersect(b.data(), b.size(), a.data(), a.size()));
+            }
+}
+
+TEST(TestIntersection, common_neighbors){
+    // small_vectorS rows are sorted int arrays and are intersected in place
+    CompactGraph g;
+    for(int v = 0; v < 300; v += 3)
+        add_edge(0, v, g);
+    for(int v = 0; v < 300; v += 5)
+        add_edge(1, v, g);
+    add_edge(2, 150, g);
+
+    std::vector<int> c = common_neighbors(0, 1, g);
+    ASSERT_EQ(20, c.size());
+    for(std::size_t i = 0; i < c.size(); ++i)
+        ASSERT_EQ(15 * static_cast<int>(i), c[i]);
+    ASSERT_EQ(1, common_neighbors(2, 0, g).size());
+    ASSERT_EQ(c, common_neighbors(0, 1, freeze(g)));
+}
+
+// --------------
+// TestThreadPool
+// --------------
+
+TEST(TestThreadPool, shared){
+    ThreadPool               pool(4);
+    std::vector<std::size_t> sums(2, 0);
+    std::vector<std::thread> callers;
+    for(unsigned c = 0; c < 2; ++c)
+        callers.push_back(std::thread([&, c] () {
+            for(int k = 0; k < 200; ++k)
+            {
+                std::atomic<std::size_t> s(0);
+                pool.parallel_for(0, 1000, 10, [&] (std::size_t b, std::size_t e, unsigned) {
+                    for(std::size_t i = b; i != e; ++i)
+                        s += i;});
+                sums[c] += s;
+            }}));
+    for(unsigned c = 0; c < 2; ++c)
+        callers[c].join();
+    ASSERT_EQ(200 * 499500, sums[0]);
+    ASSERT_EQ(200 * 499500, sums[1]);
+}
+
+TEST(TestThreadPool, exception){
+    ThreadPool pool(4);
+    for(std::size_t bad = 0; bad < 1000; bad += 250)
+        ASSERT_THROW(pool.parallel_for(0, 1000, 10, [&] (std::size_t b, std::size_t e, unsigned) {
+            if ((b <= bad) && (bad < e))
+                throw std::runtime_error("bad index");}), std::runtime_error);
+
+    std::atomic<std::size_t> n(0);
+    pool.parallel_for(0, 1000, 10, [&] (std::size_t b, std::size_t e, unsigned) {
+        n += e - b;});
+    ASSERT_EQ(1000, n);
+}
@@ -0,0 +1,181 @@
+// ---------------------------
+// projects/graph/ThreadPool.h
+// Copyright (C) 2014
+// Glenn P. Downing
+// ---------------------------
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm>          // max, min
+#include <atomic>             // atomic
+#include <condition_variable> // condition_variable
+#include <cstddef>            // size_t
+#include <exception>          // current_exception, exception_ptr, rethrow_exception
+#include <functional>         // function
+#include <mutex>              // mutex, unique_lock
+#include <thread>             // thread
+#include <vector>             // vector
+
+// ----------
+// ThreadPool
+// ----------
+
+/**
+ * fixed set of worker threads that run one parallel_for at a time
+ * the calling thread takes part as participant 0, so a pool of size 1 runs everything inline
+ * calls from different threads take turns; parallel_for must not be called from inside
+ * a parallel_for of the same pool
+ */
+class ThreadPool {
+    private:
+        // ----
+        // data
+        // ----
+
+        std::vector<std::thread>      _workers;
+        std::mutex                    _call;       // held for the whole of a parallel_for
+        std::mutex                    _m;
+        std::condition_variable       _start;
+        std::condition_variable       _done;
+        std::function<void(unsigned)> _job;
+        unsigned long                 _generation; // bumped once per parallel_for
+        unsigned                      _pending;    // workers still inside _job
+        bool                          _stop;
+
+        // ---
+        // run
+        // ---
+
+        /**
+         * @param id - participant number of this worker, 1..size()-1
+         * waits for each new generation, runs its share of the job and reports back
+         */
+        void run (unsigned id) {
+            unsigned long seen = 0;
+            for (;;) {
+                std::function<void(unsigned)>* job;
+                {
+                std::unique_lock<std::mutex> lock(_m);
+                _start.wait(lock, [&] () {return _stop || (_generation != seen);});
+                if (_stop)
+                    return;
+                seen = _generation;
+                job  = &_job;
+                }
+                (*job)(id);
+                {
+                std::unique_lock<std::mutex> lock(_m);
+                if (--_pending == 0)
+                    _done.notify_one();
+                }}}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param n - number of participants, including the caller; 0 uses std::thread::hardware_concurrency()
+         */
+        explicit ThreadPool (unsigned n = 0) :
+                _generation (0),
+                _pending    (0),
+                _stop       (false) {
+            if (n == 0)
+                n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned i = 1; i < n; ++i)
+                _workers.push_back(std::thread(&ThreadPool::run, this, i));}
+
+        ThreadPool (const ThreadPool&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+
+        ~ThreadPool () {
+            {
+            std::unique_lock<std::mutex> lock(_m);
+            _stop = true;
+            }
+            _start.notify_all();
+            for (std::size_t i = 0; i != _workers.size(); ++i)
+                _workers[i].join();}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return number of participants, i.e. the number of distinct ids parallel_for hands out
+         */
+        unsigned size () const {
+            return static_cast<unsigned>(_workers.size()) + 1;}
+
+        // ------------
+        // parallel_for
+        // ------------
+
+        /**
+         * @param b     - first index
+         * @param e     - one past the last index
+         * @param grain - indices handed out per claim
+         * @param f     - called as f(lo, hi, id) on disjoint [lo, hi) covering [b, e), id < size()
+         * blocks until every index has been processed
+         * if f throws, no further ranges are handed out and, once every participant has
+         * stopped, the first exception is rethrown in the caller
+         */
+        template <typename F>
+        void parallel_for (std::size_t b, std::size_t e, std::size_t grain, F f) {
+            if (b >= e)
+                return;
+            grain = std::max<std::size_t>(grain, 1);
+            if (_workers.empty() || (e - b <= grain)) {
+                f(b, e, 0u);
+                return;}
+
+            std::lock_guard<std::mutex> call(_call);
+            std::atomic<std::size_t> next(b);
+            std::exception_ptr       error;
+            std::mutex               error_m;
+            std::function<void(unsigned)> job = [&] (unsigned id) {
+                try {
+                    for (;;) {
+                        const std::size_t lo = next.fetch_add(grain);
+                        if (lo >= e)
+                            return;
+                        f(lo, std::min(lo + grain, e), id);}}
+                catch (...) {
+                    next.store(e);
+                    std::lock_guard<std::mutex> lock(error_m);
+                    if (!error)
+                        error = std::current_exception();}};
+            {
+            std::unique_lock<std::mutex> lock(_m);
+            _job.swap(job);
+            _pending = static_cast<unsigned>(_workers.size());
+            ++_generation;
+            }
+            _start.notify_all();
+            _job(0);
+            {
+            std::unique_lock<std::mutex> lock(_m);
+            _done.wait(lock, [&] () {return _pending == 0;});
+            }
+            if (error)
+                std::rethrow_exception(error);}};
+
+// ------------
+// default_pool
+// ------------
+
+/**
+ * @return process wide pool with one participant per hardware thread
+ * threads that share it take turns, so give a thread its own ThreadPool when calls must overlap
+ */
+inline ThreadPool& default_pool () {
+    static ThreadPool pool;
+    return pool;}
+
+#endif // ThreadPool_h